@@ -1,22 +1,39 @@
 #include "Application.h"
 
 #include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Utility/Arguments.h>
 #include <Corrade/Utility/Resource.h>
+#include <Corrade/Utility/String.h>
 #include <Magnum/AbstractShaderProgram.h>
 #include <Magnum/DefaultFramebuffer.h>
 #include <Magnum/Renderer.h>
 #include <Magnum/Buffer.h>
 #include <Magnum/Mesh.h>
+#include <Magnum/Math/Functions.h>
 #include <Magnum/MeshTools/FullScreenTriangle.h>
 #include <Magnum/Shaders/DistanceFieldVector.h>
 #include <Magnum/Text/DistanceFieldGlyphCache.h>
 #include <Magnum/Text/AbstractFont.h>
 #include <Magnum/Trade/AbstractImporter.h>
 
+#include "Game/Camera.h"
 #include "Game/Game.h"
 #include "Menu/Menu.h"
+#include "Rendering/CpuProfiler.h"
+#include "Shaders/BatchedText.h"
 #include "Splash/Splash.h"
-#include "configure.h"
+
+#ifdef PUSHTHEBOX_WITH_BENCHMARK
+#include "Benchmark/Benchmark.h"
+#endif
+
+#ifdef PUSHTHEBOX_WITH_EDITOR
+#include "Editor/Editor.h"
+#endif
+
+#ifdef PUSHTHEBOX_WITH_HEADLESS
+#include "Headless/Headless.h"
+#endif
 
 #if defined(CORRADE_TARGET_NACL_NEWLIB) || defined(CORRADE_TARGET_EMSCRIPTEN)
 static int importStaticPlugins() {
@@ -40,14 +57,69 @@ Application::Application(const Arguments& arguments): Platform::ScreenedApplicat
     CORRADE_INTERNAL_ASSERT(!_instance);
     _instance = this;
 
+    /* Command-line options */
+    Utility::Arguments args;
+    #ifdef PUSHTHEBOX_WITH_EDITOR
+    args.addOption("level-file", "custom-level.conf").setHelp("level-file", "file which the level editor loads and saves", "file.conf");
+    #endif
+    #ifdef PUSHTHEBOX_WITH_BENCHMARK
+    args.addBooleanOption("benchmark").setHelp("benchmark", "play given levels with scripted camera and moves, write frame times and exit")
+        .addOption("benchmark-levels", "easy1 medium1 hard1").setHelp("benchmark-levels", "space-separated levels played in benchmark mode", "\"names\"")
+        .addOption("benchmark-frames", "600").setHelp("benchmark-frames", "count of measured frames per level in benchmark mode", "count")
+        .addOption("benchmark-output", "benchmark.json").setHelp("benchmark-output", "file to write benchmark results to", "file.json");
+    #endif
+    #ifdef PUSHTHEBOX_WITH_HEADLESS
+    args.addBooleanOption("headless").setHelp("headless", "render a level offscreen in a hidden window, report frame times and exit")
+        .addOption("headless-level", "easy1").setHelp("headless-level", "level rendered in headless mode", "name")
+        .addOption("headless-frames", "120").setHelp("headless-frames", "count of measured frames in headless mode", "count")
+        .addOption("headless-size", "1280 720").setHelp("headless-size", "framebuffer size in headless mode", "\"X Y\"")
+        .addOption("headless-capture", "").setHelp("headless-capture", "directory to write images rendered in headless mode to", "dir")
+        .addOption("headless-reference", "").setHelp("headless-reference", "directory with reference images to compare against in headless mode", "dir")
+        .addOption("headless-tolerance", "0.5").setHelp("headless-tolerance", "largest allowed mean difference from reference images", "value");
+    #endif
+    #ifdef PUSHTHEBOX_WITH_PROFILING
+    args.addOption("trace-file", "").setHelp("trace-file", "write CPU profiling scopes as Chrome trace JSON on exit", "file.json");
+    #endif
+    args.addOption("blur", "gaussian").setHelp("blur", "menu background blur, gaussian or dual-filter", "mode")
+        .addOption("antialiasing", "msaa16").setHelp("antialiasing", "none, msaa2, msaa4, msaa8, msaa16 or fxaa", "mode")
+        .addBooleanOption("dynamic-resolution").setHelp("dynamic-resolution", "lower the scene resolution when the frame rate drops")
+        .addOption("min-resolution-scale", "0.5").setHelp("min-resolution-scale", "lowest scene resolution scale with dynamic resolution", "scale")
+        .addBooleanOption("input-latency").setHelp("input-latency", "print input to swap latency percentiles on exit")
+        .setHelp("Push The Box game.")
+        .parse(arguments.argc, arguments.argv);
+
+    /* Antialiasing mode */
+    Int sampleCount = 16;
+    bool fxaa = false;
+    const std::string antialiasing = args.value("antialiasing");
+    if(antialiasing == "none") sampleCount = 0;
+    else if(antialiasing == "fxaa") {
+        sampleCount = 0;
+        fxaa = true;
+    }
+    else if(antialiasing == "msaa2") sampleCount = 2;
+    else if(antialiasing == "msaa4") sampleCount = 4;
+    else if(antialiasing == "msaa8") sampleCount = 8;
+    else if(antialiasing != "msaa16")
+        Warning() << "Unknown antialiasing mode" << antialiasing << "- falling back to msaa16";
+
     /* Try to create MSAA context, fall back to no-AA */
     Configuration conf;
-    conf.setSampleCount(16);
+    conf.setSampleCount(sampleCount);
     #ifndef CORRADE_TARGET_NACL
     conf.setTitle("Push The Box");
     #endif
+
+    /* In headless mode the multisampling is done in the offscreen
+       framebuffer, the window is there only for the context */
+    #ifdef PUSHTHEBOX_WITH_HEADLESS
+    const bool headless = args.isSet("headless");
+    if(headless) conf.setSize(args.value<Vector2i>("headless-size"))
+        .setWindowFlags(Configuration::WindowFlag::Hidden)
+        .setSampleCount(0);
+    #endif
     if(!tryCreateContext(conf)) {
-        Debug() << "Cannot create 16x MSAA context, fallback to no antialiasing";
+        Debug() << "Cannot create MSAA context with" << sampleCount << "samples, fallback to no antialiasing";
         createContext(conf.setSampleCount(0));
     }
 
@@ -56,7 +128,7 @@ Application::Application(const Arguments& arguments): Platform::ScreenedApplicat
     Renderer::setClearColor(Color3(0.0f));
 
     /* Add resource loader and fallback meshes */
-    sceneResourceManager.setLoader(&meshResourceLoader);
+    sceneResourceManager.setLoader(&_meshResourceLoader);
     sceneResourceManager.setFallback<Mesh>(new Mesh);
 
     /* Load TGA importer plugin */
@@ -85,18 +157,79 @@ Application::Application(const Arguments& arguments): Platform::ScreenedApplicat
 
     /* Save font resources to resource manager */
     SceneResourceManager::instance().set<AbstractShaderProgram>("text2d", new Shaders::DistanceFieldVector2D)
+        .set<AbstractShaderProgram>("batched-text", new Shaders::BatchedText)
         .set("font", font.release()).set("cache", cache.release());
 
     /* Add the screens */
     _gameScreen = new Game::Game;
+    if(args.value("blur") == "dual-filter")
+        _gameScreen->camera().setBlurMode(Game::Camera::BlurMode::DualFilter);
+    else if(args.value("blur") != "gaussian")
+        Warning() << "Unknown blur mode" << args.value("blur") << "- falling back to gaussian";
+
+    /* The blurred scene is tiny, so keep at least some multisampling there
+       to avoid shimmering even without MSAA on the screen */
+    _gameScreen->camera().setBlurSampleCount(Math::max(sampleCount, 4));
+    _gameScreen->camera().setFxaa(fxaa);
+    if(args.isSet("dynamic-resolution")) {
+        const Float minScale = Math::clamp(args.value<Float>("min-resolution-scale"), 0.1f, 1.0f);
+        _gameScreen->camera().resolutionScaler().setScaleLimits(minScale, 1.0f);
+        _gameScreen->camera().setDynamicResolution(true);
+    }
+    #ifdef PUSHTHEBOX_WITH_EDITOR
+    _editorScreen = new Editor::Editor(args.value("level-file"));
+    #endif
     _menuScreen = new Menu::Menu;
     _splashScreen = new Splash::Splash;
     addScreen(*_splashScreen);
     addScreen(*_gameScreen);
+    #ifdef PUSHTHEBOX_WITH_EDITOR
+    addScreen(*_editorScreen);
+    #endif
     addScreen(*_menuScreen);
 
+    #ifdef PUSHTHEBOX_WITH_PROFILING
+    traceFile = args.value("trace-file");
+    #endif
+    printInputLatency = args.isSet("input-latency");
+
     _timeline.start();
 
+    /* Skip the splash and draw as fast as possible in benchmark and headless
+       mode */
+    #ifdef PUSHTHEBOX_WITH_BENCHMARK
+    if(args.isSet("benchmark")) {
+        #ifdef PUSHTHEBOX_WITH_HEADLESS
+        if(headless) {
+            Error() << "Benchmark and headless mode can't be combined";
+            std::exit(1);
+        }
+        #endif
+        std::vector<std::string> levels = Utility::String::splitWithoutEmptyParts(args.value("benchmark-levels"), ' ');
+        if(levels.empty()) {
+            Error() << "No levels to benchmark";
+            std::exit(1);
+        }
+        _benchmark.reset(new Benchmark::Benchmark(std::move(levels),
+            args.value<UnsignedInt>("benchmark-frames"), args.value("benchmark-output")));
+        setSwapInterval(0);
+        redraw();
+        return;
+    }
+    #endif
+    #ifdef PUSHTHEBOX_WITH_HEADLESS
+    if(headless) {
+        _headless.reset(new Headless::Headless(args.value("headless-level"),
+            args.value<Vector2i>("headless-size"), sampleCount,
+            args.value<UnsignedInt>("headless-frames"),
+            args.value("headless-capture"), args.value("headless-reference"),
+            args.value<Float>("headless-tolerance")));
+        setSwapInterval(0);
+        redraw();
+        return;
+    }
+    #endif
+
     /* Set some sane speed */
     setSwapInterval(1);
     #ifndef CORRADE_TARGET_EMSCRIPTEN
@@ -110,17 +243,64 @@ Application::~Application() {
     /* Remove all screens before deleting the resource manager, so the
        resources can be properly freed */
     while(screens().last()) removeScreen(*screens().last());
+
+    if(printInputLatency) _inputLatency.print();
+
+    #ifdef PUSHTHEBOX_WITH_PROFILING
+    if(!traceFile.empty() && !Rendering::CpuProfiler::writeTrace(traceFile))
+        Error() << "Cannot write trace to" << traceFile;
+    #endif
+}
+
+#if defined(PUSHTHEBOX_WITH_BENCHMARK) || defined(PUSHTHEBOX_WITH_HEADLESS)
+bool Application::isFailed() const {
+    #ifdef PUSHTHEBOX_WITH_BENCHMARK
+    if(_benchmark && !_benchmark->isPassed()) return true;
+    #endif
+    #ifdef PUSHTHEBOX_WITH_HEADLESS
+    if(_headless && !_headless->isPassed()) return true;
+    #endif
+    return false;
 }
+#endif
 
 void Application::globalViewportEvent(const Vector2i& size) {
     defaultFramebuffer.setViewport({{}, size});
 }
 
 void Application::globalDrawEvent() {
+    PUSHTHEBOX_PROFILE_SCOPE("Application::globalDrawEvent");
     swapBuffers();
+    _inputLatency.present();
     _timeline.nextFrame();
+    _renderQueue.nextFrame();
+    _renderTargetPool.nextFrame();
+    _gpuProfiler.nextFrame();
+
+    #ifdef PUSHTHEBOX_WITH_BENCHMARK
+    if(_benchmark) {
+        if(_benchmark->nextFrame()) redraw();
+        else exit();
+    }
+    #endif
+    #ifdef PUSHTHEBOX_WITH_HEADLESS
+    if(_headless) {
+        if(_headless->nextFrame()) redraw();
+        else exit();
+    }
+    #endif
 }
 
 }
 
+#if defined(PUSHTHEBOX_WITH_BENCHMARK) || defined(PUSHTHEBOX_WITH_HEADLESS)
+/* Like MAGNUM_APPLICATION_MAIN(), but reports failed benchmark or image
+   comparison in the exit code */
+int main(int argc, char** argv) {
+    PushTheBox::Application app({argc, argv});
+    const int result = app.exec();
+    return result ? result : int(app.isFailed());
+}
+#else
 MAGNUM_APPLICATION_MAIN(PushTheBox::Application)
+#endif
@@ -5,6 +5,7 @@
  * @brief Class PushTheBox::Application
  */
 
+#include <memory>
 #include <Corrade/Interconnect/Receiver.h>
 #include <Corrade/PluginManager/Manager.h>
 #include <Magnum/ResourceManager.h>
@@ -14,14 +15,37 @@
 #include <Magnum/Platform/Sdl2Application.h>
 
 #include "PushTheBox.h"
+#include "Rendering/GpuProfiler.h"
+#include "Rendering/InputLatency.h"
+#include "Rendering/RenderQueue.h"
+#include "Rendering/RenderTargetPool.h"
 #include "ResourceManagement/MeshResourceLoader.h"
+#include "configure.h"
 
 namespace PushTheBox {
 
+#ifdef PUSHTHEBOX_WITH_BENCHMARK
+namespace Benchmark {
+    class Benchmark;
+}
+#endif
+
+#ifdef PUSHTHEBOX_WITH_EDITOR
+namespace Editor {
+    class Editor;
+}
+#endif
+
 namespace Game {
     class Game;
 }
 
+#ifdef PUSHTHEBOX_WITH_HEADLESS
+namespace Headless {
+    class Headless;
+}
+#endif
+
 namespace Menu {
     class Menu;
 }
@@ -40,12 +64,42 @@ class Application: public Platform::ScreenedApplication, public Interconnect::Re
 
         ~Application();
 
+        #if defined(PUSHTHEBOX_WITH_BENCHMARK) || defined(PUSHTHEBOX_WITH_HEADLESS)
+        /**
+         * @brief Whether the application failed
+         *
+         * `true` if benchmark results couldn't be written or images rendered
+         * in headless mode didn't match the references, `false` otherwise.
+         */
+        bool isFailed() const;
+        #endif
+
         /** @brief Game screen */
         inline Game::Game* gameScreen() { return _gameScreen; }
 
         /** @brief Menu screen */
         inline Menu::Menu* menuScreen() { return _menuScreen; }
 
+        #ifdef PUSHTHEBOX_WITH_EDITOR
+        /** @brief Level editor screen */
+        inline Editor::Editor* editorScreen() { return _editorScreen; }
+        #endif
+
+        /** @brief Mesh resource loader */
+        inline ResourceManagement::MeshResourceLoader& meshResourceLoader() { return _meshResourceLoader; }
+
+        /** @brief Render queue */
+        inline Rendering::RenderQueue& renderQueue() { return _renderQueue; }
+
+        /** @brief Render target pool */
+        inline Rendering::RenderTargetPool& renderTargetPool() { return _renderTargetPool; }
+
+        /** @brief GPU profiler */
+        inline Rendering::GpuProfiler& gpuProfiler() { return _gpuProfiler; }
+
+        /** @brief Input latency */
+        inline Rendering::InputLatency& inputLatency() { return _inputLatency; }
+
         /** @brief Timeline */
         inline Timeline& timeline() { return _timeline; }
 
@@ -58,12 +112,31 @@ class Application: public Platform::ScreenedApplication, public Interconnect::Re
         PluginManager::Manager<Trade::AbstractImporter> importerPluginManager;
         PluginManager::Manager<Text::AbstractFont> fontPluginManager;
         SceneResourceManager sceneResourceManager;
-        ResourceManagement::MeshResourceLoader meshResourceLoader;
+        ResourceManagement::MeshResourceLoader _meshResourceLoader;
+        Rendering::RenderQueue _renderQueue;
+        Rendering::RenderTargetPool _renderTargetPool;
+        Rendering::GpuProfiler _gpuProfiler;
+        Rendering::InputLatency _inputLatency;
         Timeline _timeline;
+        bool printInputLatency;
 
         Game::Game* _gameScreen;
         Menu::Menu* _menuScreen;
         Splash::Splash* _splashScreen;
+        #ifdef PUSHTHEBOX_WITH_EDITOR
+        Editor::Editor* _editorScreen;
+        #endif
+
+        #ifdef PUSHTHEBOX_WITH_BENCHMARK
+        std::unique_ptr<Benchmark::Benchmark> _benchmark;
+        #endif
+        #ifdef PUSHTHEBOX_WITH_HEADLESS
+        std::unique_ptr<Headless::Headless> _headless;
+        #endif
+
+        #ifdef PUSHTHEBOX_WITH_PROFILING
+        std::string traceFile;
+        #endif
 };
 
 }
@@ -0,0 +1,121 @@
+#include "Benchmark.h"
+
+#include <fstream>
+#include <utility>
+#include <Corrade/Utility/Assert.h>
+#include <Corrade/Utility/Debug.h>
+#include <Magnum/Context.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Vector2.h>
+
+#include "Application.h"
+#include "Game/Game.h"
+
+namespace PushTheBox { namespace Benchmark {
+
+namespace {
+    /* Frames drawn before measuring, at least, while HUD animations are
+       running the warm-up continues */
+    constexpr UnsignedInt WarmupFrameCount = 10;
+
+    /* The player tries to walk in a square, one move each few frames. Moves
+       blocked by walls are simply skipped. */
+    constexpr UnsignedInt MoveInterval = 20;
+    const Vector2i moves[]{{0, -1}, {-1, 0}, {0, 1}, {1, 0}};
+
+    std::string escape(const std::string& string) {
+        std::string out;
+        for(const char c: string) {
+            if(c == '"' || c == '\\') out += '\\';
+            out += c;
+        }
+        return out;
+    }
+}
+
+Benchmark::Benchmark(std::vector<std::string> levels, const UnsignedInt frameCount, std::string output): levels(std::move(levels)), frameCount(Math::max(frameCount, 1u)), output(std::move(output)), currentLevel(0), _passed(false) {
+    CORRADE_ASSERT(!this->levels.empty(), "Benchmark::Benchmark: no levels to benchmark", );
+
+    startLevel();
+    Application::instance()->gameScreen()->resume();
+}
+
+void Benchmark::startLevel() {
+    Game::Game& game = *Application::instance()->gameScreen();
+    game.loadLevel(levels[currentLevel]);
+    game.setPlayerRotation(Deg(0.0f));
+
+    /* Wait only for the level to be loaded in the simulation. The scripted
+       moves later aren't waited for, so the simulation runs alongside
+       rendering the same way as when playing. */
+    game.synchronize();
+
+    statistics.clear();
+    warmupFrame = 0;
+    frame = 0;
+}
+
+bool Benchmark::nextFrame() {
+    const std::chrono::steady_clock::time_point frameEnd = std::chrono::steady_clock::now();
+    Game::Game& game = *Application::instance()->gameScreen();
+
+    /* Warm up */
+    if(!frame && (warmupFrame < WarmupFrameCount || game.isAnimating())) {
+        ++warmupFrame;
+
+    /* Measure the frame */
+    } else {
+        statistics.add(std::chrono::duration<Double, std::milli>(frameEnd - frameStart).count());
+
+        /* Level done, continue with next one or finish */
+        if(++frame == frameCount) {
+            results.push_back({levels[currentLevel], statistics.average(), statistics.percentile(95.0), statistics.percentile(99.0), statistics.worst()});
+            Debug() << "Level" << levels[currentLevel] << "frame time average" << results.back().average << "ms, p95" << results.back().p95 << "ms, p99" << results.back().p99 << "ms, worst" << results.back().worst << "ms";
+
+            if(++currentLevel == levels.size()) {
+                if(!(_passed = writeResults()))
+                    Error() << "Cannot write benchmark results to" << output;
+                return false;
+            }
+
+            startLevel();
+
+        /* Script the next frame */
+        } else {
+            game.setPlayerRotation(Deg(360.0f*frame/frameCount));
+            if(frame % MoveInterval == 0)
+                game.movePlayer(moves[frame/MoveInterval % 4]);
+        }
+    }
+
+    frameStart = frameEnd;
+    return true;
+}
+
+bool Benchmark::writeResults() const {
+    std::ofstream out(output);
+    if(!out.good()) return false;
+
+    out << std::fixed;
+    out.precision(3);
+
+    const Vector2i size = Application::instance()->windowSize();
+    out << "{\n  \"renderer\": \"" << escape(Context::current().rendererString())
+        << "\",\n  \"version\": \"" << escape(Context::current().versionString())
+        << "\",\n  \"size\": [" << size.x() << ", " << size.y()
+        << "],\n  \"frames\": " << frameCount
+        << ",\n  \"levels\": [";
+    for(std::size_t i = 0; i != results.size(); ++i) {
+        const Result& result = results[i];
+        out << (i ? ",\n" : "\n") << "    {\"name\": \"" << escape(result.level)
+            << "\", \"average\": " << result.average
+            << ", \"p95\": " << result.p95
+            << ", \"p99\": " << result.p99
+            << ", \"worst\": " << result.worst << "}";
+    }
+    out << "\n  ]\n}\n";
+
+    return out.good();
+}
+
+}}
@@ -0,0 +1,82 @@
+#ifndef PushTheBox_Benchmark_Benchmark_h
+#define PushTheBox_Benchmark_Benchmark_h
+
+/** @file
+ * @brief Class PushTheBox::Benchmark::Benchmark
+ */
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "PushTheBox.h"
+#include "Rendering/DurationStatistics.h"
+
+namespace PushTheBox { namespace Benchmark {
+
+/**
+@brief Frame time benchmark
+
+Plays given levels one after another in the window. After a warm-up, during
+which HUD animations of the freshly loaded level finish, the camera makes one
+orbit around the player over the measured frames and the player makes a
+fixed sequence of moves, pushing boxes on the way. Everything depends only on
+the frame index, so the results are comparable across machines and builds.
+The game simulation is waited for only after loading each level, the
+scripted moves are drawn once the simulation publishes them, the same way as
+when playing.
+
+Frame time is the time between consecutive buffer swaps, so vertical sync
+should be disabled. When all levels are done, average, 95th and 99th
+percentile and worst frame time of each level are written as JSON.
+*/
+class Benchmark {
+    public:
+        /**
+         * @brief Constructor
+         * @param levels        Benchmarked levels, expected to be
+         *      non-empty
+         * @param frameCount    Count of measured frames per level
+         * @param output        JSON file to write the results to
+         *
+         * Expects that the game screen is already created. Loads the first
+         * level and focuses the game screen.
+         */
+        explicit Benchmark(std::vector<std::string> levels, UnsignedInt frameCount, std::string output);
+
+        /**
+         * @brief Finish frame
+         * @return `false` if all levels are done, `true` otherwise
+         *
+         * Called after each buffer swap. Measures the frame and prepares the
+         * next one. When done, writes the results.
+         */
+        bool nextFrame();
+
+        /** @brief Whether the results were written */
+        inline bool isPassed() const { return _passed; }
+
+    private:
+        struct Result {
+            std::string level;
+            Double average, p95, p99, worst;
+        };
+
+        void startLevel();
+        bool writeResults() const;
+
+        const std::vector<std::string> levels;
+        const UnsignedInt frameCount;
+        const std::string output;
+
+        std::vector<Result> results;
+        Rendering::DurationStatistics statistics;
+        std::chrono::steady_clock::time_point frameStart;
+        std::size_t currentLevel;
+        UnsignedInt warmupFrame, frame;
+        bool _passed;
+};
+
+}}
+
+#endif
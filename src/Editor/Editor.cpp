@@ -0,0 +1,313 @@
+#include "Editor.h"
+
+#include <Corrade/Utility/Configuration.h>
+#include <Corrade/Utility/Directory.h>
+#include <Magnum/DefaultFramebuffer.h>
+#include <Magnum/Renderer.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/SceneGraph/Camera2D.h>
+#include <Magnum/Text/Alignment.h>
+
+#include "Application.h"
+#include "Editor/Grid.h"
+#include "Editor/Label.h"
+
+namespace PushTheBox { namespace Editor {
+
+namespace {
+    typedef Game::Level::TileType TileType;
+
+    const Vector2i DefaultSize{16, 12};
+
+    const char* const ToolNames[]{
+        "floor", "wall", "box", "target", "box on target", "player", "erase"
+    };
+
+    const Color3 checkingColor = Color3::fromHsv(Deg(50.0f), 0.6f, 1.0f);
+    const Color3 solvableColor = Color3::fromHsv(Deg(120.0f), 0.6f, 1.0f);
+    const Color3 brokenColor = Color3::fromHsv(Deg(0.0f), 0.6f, 1.0f);
+
+    /* The same characters as Level parses */
+    char tileCharacter(TileType type, bool player) {
+        switch(type) {
+            case TileType::Empty: return ' ';
+            case TileType::Wall: return '#';
+            case TileType::Floor: return player ? '@' : '_';
+            case TileType::Box: return '$';
+            case TileType::Target: return player ? '+' : '.';
+            case TileType::BoxOnTarget: return '*';
+        }
+
+        return ' ';
+    }
+
+    bool isWalkable(TileType type) {
+        return type == TileType::Floor || type == TileType::Target;
+    }
+}
+
+Editor::Editor(std::string filename): _filename(std::move(filename)), _size(DefaultSize), _playerPosition(-1, -1), _tiles(DefaultSize.product(), TileType::Empty), _tool(Tool::Wall), result{Solver::Verdict::Invalid, {}, 0, 0}, checking(false) {
+    /* Configure camera */
+    camera = new SceneGraph::Camera2D(scene);
+    camera->setProjectionMatrix(Matrix3::projection({8.0f/3.0f, 2.0f}))
+        .setAspectRatioPolicy(SceneGraph::AspectRatioPolicy::Extend)
+        .setViewport(defaultFramebuffer.viewport().size());
+
+    grid = new Grid(_tiles, _size, _playerPosition, &scene, &drawables);
+
+    (help = new Label(Text::Alignment::TopLeft, &scene, &drawables))
+        ->translate({-1.303f, 0.97f});
+    help->update("1-7 select tool, left button paint, right button erase, F2 save, Esc menu");
+
+    (status = new Label(Text::Alignment::LineLeft, &scene, &drawables))
+        ->translate({-1.303f, -0.95f});
+
+    /* Continue where the designer left off */
+    load();
+    edited();
+}
+
+Editor::~Editor() = default;
+
+void Editor::open() {
+    Application::instance()->focusScreen(*this);
+}
+
+void Editor::close() {
+    Application::instance()->focusScreen(*Application::instance()->menuScreen());
+}
+
+bool Editor::load() {
+    if(!Utility::Directory::fileExists(_filename)) return false;
+
+    Utility::Configuration conf(_filename, Utility::Configuration::Flag::ReadOnly);
+    if(conf.value("type") != "classic") {
+        Warning() << "Editor::Editor::load(): unsupported level type" << conf.value("type") << "in" << _filename;
+        return false;
+    }
+
+    /* Center the level in the grid */
+    const Vector2i levelSize = conf.value<Vector2i>("size");
+    _size = Math::max(levelSize, DefaultSize);
+    _tiles.assign(_size.product(), TileType::Empty);
+    _playerPosition = {-1, -1};
+    const Vector2i offset = (_size - levelSize)/2;
+
+    Vector2i position;
+    for(const char c: conf.value("data")) {
+        if(c == '\n') {
+            position.x() = 0;
+            ++position.y();
+            continue;
+        }
+
+        if((position >= levelSize).any()) {
+            Warning() << "Editor::Editor::load(): level data in" << _filename << "don't match its size";
+            break;
+        }
+
+        TileType& type = _tiles[(position.y() + offset.y())*_size.x() + position.x() + offset.x()];
+        switch(c) {
+            case '#': type = TileType::Wall; break;
+            case '@': _playerPosition = position + offset;
+                      /* No break, as we need to mark it as floor */
+            case '_': type = TileType::Floor; break;
+            case '$': type = TileType::Box; break;
+            case '+': _playerPosition = position + offset;
+                      /* No break, as we need to mark it as target */
+            case '.': type = TileType::Target; break;
+            case '*': type = TileType::BoxOnTarget; break;
+        }
+
+        ++position.x();
+    }
+
+    return true;
+}
+
+void Editor::save() {
+    const Solver::Problem level = trimmed();
+    if(level.tiles.empty()) {
+        saveMessage = "nothing to save";
+        updateStatus();
+        return;
+    }
+
+    /* Level data, one row per line without trailing spaces */
+    std::string data;
+    for(Int y = 0; y != level.size.y(); ++y) {
+        std::string row;
+        for(Int x = 0; x != level.size.x(); ++x)
+            row += tileCharacter(level.tiles[y*level.size.x() + x], level.playerPosition == Vector2i{x, y});
+        data += row.substr(0, row.find_last_not_of(' ') + 1) + '\n';
+    }
+
+    Utility::Configuration conf(_filename, Utility::Configuration::Flag::Truncate);
+    conf.setValue("type", "classic");
+    conf.setValue("next", "easy1");
+    conf.setValue("title", "Custom level");
+    conf.setValue("size", level.size);
+    conf.setValue("data", data);
+
+    saveMessage = conf.save() ? "saved to " + _filename : "can't save to " + _filename;
+    updateStatus();
+}
+
+Vector2i Editor::cellAt(const Vector2i& screenPosition) const {
+    return grid->cellAt(Vector2::yScale(-1.0f)*(Vector2(screenPosition)/Vector2(defaultFramebuffer.viewport().size())-Vector2(0.5f))*camera->projectionSize());
+}
+
+Solver::Problem Editor::trimmed() const {
+    /* Bounding rectangle of non-empty cells */
+    Vector2i min = _size, max{-1, -1};
+    for(Int y = 0; y != _size.y(); ++y) for(Int x = 0; x != _size.x(); ++x) {
+        if(_tiles[y*_size.x() + x] == TileType::Empty) continue;
+        min = Math::min(min, Vector2i{x, y});
+        max = Math::max(max, Vector2i{x, y});
+    }
+
+    Solver::Problem level{{}, {}, {-1, -1}};
+    if(max == Vector2i{-1, -1}) return level;
+
+    level.size = max - min + Vector2i{1};
+    level.tiles.reserve(level.size.product());
+    for(Int y = min.y(); y <= max.y(); ++y) for(Int x = min.x(); x <= max.x(); ++x)
+        level.tiles.push_back(_tiles[y*_size.x() + x]);
+    if(_playerPosition != Vector2i{-1, -1})
+        level.playerPosition = _playerPosition - min;
+
+    return level;
+}
+
+void Editor::paint(const Vector2i& position, Tool tool) {
+    if(position == Vector2i{-1, -1}) return;
+
+    TileType& type = _tiles[position.y()*_size.x() + position.x()];
+    const TileType previousType = type;
+    const Vector2i previousPlayerPosition = _playerPosition;
+
+    switch(tool) {
+        case Tool::Floor: type = TileType::Floor; break;
+        case Tool::Wall: type = TileType::Wall; break;
+        case Tool::Box: type = TileType::Box; break;
+        case Tool::Target: type = TileType::Target; break;
+        case Tool::BoxOnTarget: type = TileType::BoxOnTarget; break;
+        case Tool::Empty: type = TileType::Empty; break;
+
+        /* Player can stand only on floor or target, keep the target */
+        case Tool::Player:
+            if(type == TileType::BoxOnTarget) type = TileType::Target;
+            else if(!isWalkable(type)) type = TileType::Floor;
+            _playerPosition = position;
+            break;
+    }
+
+    /* Player was overwritten */
+    if(_playerPosition == position && !isWalkable(type))
+        _playerPosition = {-1, -1};
+
+    if(type != previousType || _playerPosition != previousPlayerPosition)
+        edited();
+}
+
+void Editor::edited() {
+    saveMessage.clear();
+    checker.check(trimmed());
+    checking = true;
+    updateStatus();
+    redraw();
+}
+
+void Editor::updateStatus() {
+    std::string text = ToolNames[UnsignedByte(_tool) - 1];
+    text += "  |  ";
+
+    if(checking) {
+        text += "checking...";
+        status->setColor(checkingColor);
+    } else {
+        text += result.message;
+        status->setColor(result.verdict == Solver::Verdict::Solvable ? solvableColor :
+            result.verdict == Solver::Verdict::TooComplex ? checkingColor : brokenColor);
+    }
+
+    if(!saveMessage.empty()) text += "  |  " + saveMessage;
+
+    status->update(text);
+}
+
+void Editor::focusEvent() {
+    setPropagatedEvents(PropagatedEvent::Draw|PropagatedEvent::Input);
+}
+
+void Editor::blurEvent() {
+    setPropagatedEvents({});
+}
+
+void Editor::viewportEvent(const Vector2i& size) {
+    camera->setViewport(size);
+}
+
+void Editor::drawEvent() {
+    /* Pick up the verdict, if the checker has one */
+    if(checking && checker.fetch(result)) {
+        checking = false;
+        updateStatus();
+    }
+
+    Renderer::enable(Renderer::Feature::Blending);
+    Renderer::setBlendFunction(Renderer::BlendFunction::One, Renderer::BlendFunction::OneMinusSourceAlpha);
+    Renderer::disable(Renderer::Feature::DepthTest);
+    camera->draw(drawables);
+    Renderer::enable(Renderer::Feature::DepthTest);
+    Renderer::disable(Renderer::Feature::Blending);
+
+    /* Keep polling until the checker is done */
+    if(checking) redraw();
+}
+
+void Editor::keyPressEvent(KeyEvent& event) {
+    switch(event.key()) {
+        case KeyEvent::Key::One: _tool = Tool::Floor; break;
+        case KeyEvent::Key::Two: _tool = Tool::Wall; break;
+        case KeyEvent::Key::Three: _tool = Tool::Box; break;
+        case KeyEvent::Key::Four: _tool = Tool::Target; break;
+        case KeyEvent::Key::Five: _tool = Tool::BoxOnTarget; break;
+        case KeyEvent::Key::Six: _tool = Tool::Player; break;
+        case KeyEvent::Key::Seven: _tool = Tool::Empty; break;
+
+        case KeyEvent::Key::F2: save(); break;
+        case KeyEvent::Key::Esc: close(); break;
+
+        default: return;
+    }
+
+    updateStatus();
+    event.setAccepted();
+    redraw();
+}
+
+void Editor::mousePressEvent(MouseEvent& event) {
+    if(event.button() == MouseEvent::Button::Left)
+        paint(cellAt(event.position()), _tool);
+    else if(event.button() == MouseEvent::Button::Right)
+        paint(cellAt(event.position()), Tool::Empty);
+    else return;
+
+    event.setAccepted();
+    redraw();
+}
+
+void Editor::mouseMoveEvent(MouseMoveEvent& event) {
+    /* Paint while dragging */
+    if(event.buttons() & MouseMoveEvent::Button::Left)
+        paint(cellAt(event.position()), _tool);
+    else if(event.buttons() & MouseMoveEvent::Button::Right)
+        paint(cellAt(event.position()), Tool::Empty);
+    else return;
+
+    event.setAccepted();
+    redraw();
+}
+
+}}
@@ -0,0 +1,109 @@
+#ifndef PushTheBox_Editor_Editor_h
+#define PushTheBox_Editor_Editor_h
+
+/** @file
+ * @brief Class PushTheBox::Editor::Editor
+ */
+
+#include <Corrade/Interconnect/Receiver.h>
+#include <Magnum/Platform/Screen.h>
+#include <Magnum/Platform/Sdl2Application.h>
+#include <Magnum/SceneGraph/Drawable.h>
+#include <Magnum/SceneGraph/Scene.h>
+#include <Magnum/SceneGraph/TranslationTransformation.h>
+
+#include "PushTheBox.h"
+#include "Editor/SolvabilityChecker.h"
+
+namespace PushTheBox { namespace Editor {
+
+class Grid;
+class Label;
+
+/**
+@brief %Level editor screen
+
+Places walls, floors, boxes and targets on a grid and saves the result in the
+same format @ref Game::Level reads. After every edit the level is re-checked
+with @ref SolvabilityChecker in the background and the verdict is shown at the
+bottom of the screen.
+*/
+class Editor: public Platform::Screen, public Interconnect::Receiver {
+    public:
+        /** @brief Tool placed with left mouse button */
+        enum class Tool: UnsignedByte {
+            Floor = 1,      /**< Floor */
+            Wall,           /**< Wall */
+            Box,            /**< Box */
+            Target,         /**< Target */
+            BoxOnTarget,    /**< Box on target */
+            Player,         /**< Starting position */
+            Empty           /**< Erase */
+        };
+
+        /**
+         * @brief Constructor
+         * @param filename  File to which to save the level
+         *
+         * If the file exists, it is loaded.
+         */
+        explicit Editor(std::string filename);
+
+        ~Editor();
+
+        /** @brief Switch to the editor */
+        void open();
+
+        /** @brief Switch back to the menu */
+        void close();
+
+        /**
+         * @brief Save the level to file
+         *
+         * Only the bounding rectangle of non-empty cells is saved.
+         */
+        void save();
+
+        /**
+         * @brief Load the level from file
+         * @return `False` if the file doesn't exist or is not a valid level,
+         *      `true` otherwise
+         */
+        bool load();
+
+    protected:
+        void focusEvent() override;
+        void blurEvent() override;
+        void viewportEvent(const Vector2i& size) override;
+        void drawEvent() override;
+        void keyPressEvent(KeyEvent& event) override;
+        void mousePressEvent(MouseEvent& event) override;
+        void mouseMoveEvent(MouseMoveEvent& event) override;
+
+    private:
+        Vector2i cellAt(const Vector2i& screenPosition) const;
+        Solver::Problem trimmed() const;
+        void paint(const Vector2i& position, Tool tool);
+        void edited();
+        void updateStatus();
+
+        std::string _filename;
+        Vector2i _size, _playerPosition;
+        std::vector<Game::Level::TileType> _tiles;
+        Tool _tool;
+
+        Scene2D scene;
+        SceneGraph::DrawableGroup2D drawables;
+        SceneGraph::Camera2D* camera;
+        Grid* grid;
+        Label *help, *status;
+
+        SolvabilityChecker checker;
+        Solver::Result result;
+        bool checking;
+        std::string saveMessage;
+};
+
+}}
+
+#endif
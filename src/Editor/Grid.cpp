@@ -0,0 +1,84 @@
+#include "Grid.h"
+
+#include <Magnum/Color.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Primitives/Square.h>
+#include <Magnum/SceneGraph/AbstractCamera.h>
+#include <Magnum/Trade/MeshData2D.h>
+
+namespace PushTheBox { namespace Editor {
+
+namespace {
+    typedef Game::Level::TileType TileType;
+
+    /* Same colors as the game uses */
+    const Color3 empty = Color3::fromHsv(Deg(0.0f), 0.0f, 0.12f);
+    const Color3 floorTile = Color3::fromHsv(Deg(60.0f), 0.1f, 0.8f);
+    const Color3 wall = Color3::fromHsv(Deg(30.0f), 0.2f, 1.0f);
+    const Color3 target = Color3::fromHsv(Deg(120.0f), 1.0f, 0.6f);
+    const Color3 boxOff = Color3::fromHsv(Deg(0.0f), 1.0f, 0.6f);
+    const Color3 boxOn = Color3::fromHsv(Deg(120.0f), 1.0f, 0.4f);
+    const Color3 player = Color3::fromHsv(Deg(210.0f), 0.85f, 0.8f);
+}
+
+Grid::Grid(const std::vector<Game::Level::TileType>& tiles, const Vector2i& size, const Vector2i& playerPosition, Object2D* parent, SceneGraph::DrawableGroup2D* drawables): Object2D(parent), SceneGraph::Drawable2D(*this, drawables), tiles(tiles), size(size), playerPosition(playerPosition) {
+    /* Unit square */
+    Trade::MeshData2D data = Primitives::Square::solid();
+    vertices.setData(data.positions(0), BufferUsage::StaticDraw);
+    mesh.setPrimitive(data.primitive())
+        .setCount(data.positions(0).size())
+        .addVertexBuffer(vertices, 0, Magnum::Shaders::Flat2D::Position());
+}
+
+Float Grid::cellSize() const {
+    /* Fit the grid between the help and status lines */
+    return Math::min(2.4f/size.x(), 1.6f/size.y());
+}
+
+Vector2 Grid::cellCenter(const Vector2i& position) const {
+    return Vector2{position.x() - (size.x() - 1)*0.5f, (size.y() - 1)*0.5f - position.y()}*cellSize();
+}
+
+Vector2i Grid::cellAt(const Vector2& point) const {
+    const Vector2 cell = Vector2::yScale(-1.0f)*point/cellSize() + Vector2(size - Vector2i(1))*0.5f;
+    const Vector2i position{Int(Math::round(cell.x())), Int(Math::round(cell.y()))};
+    if((position < Vector2i()).any() || (position >= size).any()) return {-1, -1};
+    return position;
+}
+
+void Grid::draw(const Matrix3& transformationMatrix, SceneGraph::Camera2D& camera) {
+    const Matrix3 transformationProjection = camera.projectionMatrix()*transformationMatrix;
+    const Float cell = cellSize();
+
+    for(Int y = 0; y != size.y(); ++y) for(Int x = 0; x != size.x(); ++x) {
+        const TileType type = tiles[y*size.x() + x];
+        const Matrix3 cellTransformation = transformationProjection*Matrix3::translation(cellCenter({x, y}));
+
+        /* Base tile */
+        Color3 color;
+        switch(type) {
+            case TileType::Empty: color = empty; break;
+            case TileType::Wall: color = wall; break;
+            case TileType::Floor:
+            case TileType::Box: color = floorTile; break;
+            case TileType::Target:
+            case TileType::BoxOnTarget: color = target; break;
+        }
+        shader.setTransformationProjectionMatrix(cellTransformation*Matrix3::scaling(Vector2(cell*0.46f)))
+            .setColor(color);
+        mesh.draw(shader);
+
+        /* Box or player on top of it */
+        if(type == TileType::Box || type == TileType::BoxOnTarget)
+            color = type == TileType::Box ? boxOff : boxOn;
+        else if(playerPosition == Vector2i{x, y})
+            color = player;
+        else continue;
+
+        shader.setTransformationProjectionMatrix(cellTransformation*Matrix3::scaling(Vector2(cell*0.3f)))
+            .setColor(color);
+        mesh.draw(shader);
+    }
+}
+
+}}
@@ -0,0 +1,61 @@
+#ifndef PushTheBox_Editor_Grid_h
+#define PushTheBox_Editor_Grid_h
+
+/** @file
+ * @brief Class PushTheBox::Editor::Grid
+ */
+
+#include <vector>
+#include <Magnum/Buffer.h>
+#include <Magnum/Mesh.h>
+#include <Magnum/SceneGraph/Drawable.h>
+#include <Magnum/SceneGraph/TranslationTransformation.h>
+#include <Magnum/Shaders/Flat.h>
+
+#include "PushTheBox.h"
+#include "Game/Level.h"
+
+namespace PushTheBox { namespace Editor {
+
+/** @brief Grid of editor cells */
+class Grid: public Object2D, SceneGraph::Drawable2D {
+    public:
+        /**
+         * @brief Constructor
+         * @param tiles             Tile data
+         * @param size              Grid size
+         * @param playerPosition    Player position
+         * @param parent            Parent object
+         * @param drawables         Drawable group
+         */
+        explicit Grid(const std::vector<Game::Level::TileType>& tiles, const Vector2i& size, const Vector2i& playerPosition, Object2D* parent, SceneGraph::DrawableGroup2D* drawables);
+
+        /** @brief Size of one cell */
+        Float cellSize() const;
+
+        /** @brief Center of given cell */
+        Vector2 cellCenter(const Vector2i& position) const;
+
+        /**
+         * @brief Cell at given point
+         *
+         * Returns `{-1, -1}` if the point is outside of the grid.
+         */
+        Vector2i cellAt(const Vector2& point) const;
+
+    protected:
+        void draw(const Matrix3& transformationMatrix, SceneGraph::Camera2D& camera) override;
+
+    private:
+        const std::vector<Game::Level::TileType>& tiles;
+        const Vector2i& size;
+        const Vector2i& playerPosition;
+
+        Magnum::Shaders::Flat2D shader;
+        Buffer vertices;
+        Mesh mesh;
+};
+
+}}
+
+#endif
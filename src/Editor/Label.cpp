@@ -0,0 +1,39 @@
+#include "Label.h"
+
+#include <Magnum/ResourceManager.h>
+#include <Magnum/SceneGraph/AbstractCamera.h>
+#include <Magnum/Shaders/DistanceFieldVector.h>
+#include <Magnum/Text/AbstractFont.h>
+#include <Magnum/Text/GlyphCache.h>
+#include <Magnum/Text/Renderer.h>
+
+namespace PushTheBox { namespace Editor {
+
+Label::Label(Text::Alignment alignment, Object2D* parent, SceneGraph::DrawableGroup2D* drawables): Object2D(parent), SceneGraph::Drawable2D(*this, drawables), shader(SceneResourceManager::instance().get<AbstractShaderProgram, Magnum::Shaders::DistanceFieldVector2D>("text2d")), font(SceneResourceManager::instance().get<Text::AbstractFont>("font")), glyphCache(SceneResourceManager::instance().get<Text::GlyphCache>("cache")), color(1.0f), capacity(96) {
+    text.reset(new Text::Renderer2D(*font, *glyphCache, 0.05f, alignment));
+    text->reserve(capacity, BufferUsage::DynamicDraw, BufferUsage::StaticDraw);
+}
+
+Label::~Label() = default;
+
+void Label::update(const std::string& text) {
+    /* The text can contain user-supplied file name, grow the buffers if it
+       doesn't fit. There's never more glyphs than UTF-8 bytes. */
+    if(text.size() > capacity) {
+        capacity = text.size();
+        this->text->reserve(capacity, BufferUsage::DynamicDraw, BufferUsage::StaticDraw);
+    }
+
+    this->text->render(text);
+}
+
+void Label::draw(const Matrix3& transformationMatrix, SceneGraph::Camera2D& camera) {
+    shader->setTransformationProjectionMatrix(camera.projectionMatrix()*transformationMatrix)
+        .setColor(color)
+        .setOutlineRange(0.5f, 1.0f)
+        .setVectorTexture(glyphCache->texture());
+
+    text->mesh().draw(*shader);
+}
+
+}}
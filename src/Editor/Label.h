@@ -0,0 +1,53 @@
+#ifndef PushTheBox_Editor_Label_h
+#define PushTheBox_Editor_Label_h
+
+/** @file
+ * @brief Class PushTheBox::Editor::Label
+ */
+
+#include <memory>
+#include <Magnum/Color.h>
+#include <Magnum/Resource.h>
+#include <Magnum/SceneGraph/Drawable.h>
+#include <Magnum/SceneGraph/TranslationTransformation.h>
+#include <Magnum/Shaders/Shaders.h>
+#include <Magnum/Text/Text.h>
+
+#include "PushTheBox.h"
+
+namespace PushTheBox { namespace Editor {
+
+/** @brief Line of editor text */
+class Label: public Object2D, SceneGraph::Drawable2D {
+    public:
+        /**
+         * @brief Constructor
+         * @param alignment     Text alignment
+         * @param parent        Parent object
+         * @param drawables     Drawable group
+         */
+        explicit Label(Text::Alignment alignment, Object2D* parent, SceneGraph::DrawableGroup2D* drawables);
+
+        ~Label();
+
+        /** @brief Set text color */
+        void setColor(const Color3& color) { this->color = color; }
+
+        /** @brief Update text */
+        void update(const std::string& text);
+
+    protected:
+        void draw(const Matrix3& transformationMatrix, SceneGraph::Camera2D& camera) override;
+
+    private:
+        Resource<AbstractShaderProgram, Magnum::Shaders::DistanceFieldVector2D> shader;
+        Resource<Text::AbstractFont> font;
+        Resource<Text::GlyphCache> glyphCache;
+        std::unique_ptr<Text::Renderer2D> text;
+        Color3 color;
+        std::size_t capacity;
+};
+
+}}
+
+#endif
@@ -0,0 +1,67 @@
+#include "SolvabilityChecker.h"
+
+namespace PushTheBox { namespace Editor {
+
+SolvabilityChecker::SolvabilityChecker(): cancelled(false), quit(false), pending(false), available(false), result{Solver::Verdict::Invalid, {}, 0, 0}, thread(&SolvabilityChecker::run, this) {}
+
+SolvabilityChecker::~SolvabilityChecker() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+        cancelled = true;
+    }
+
+    condition.notify_one();
+    thread.join();
+}
+
+void SolvabilityChecker::check(Solver::Problem problem) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->problem = std::move(problem);
+        pending = true;
+        available = false;
+        cancelled = true;
+    }
+
+    condition.notify_one();
+}
+
+bool SolvabilityChecker::fetch(Solver::Result& result) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if(!available) return false;
+
+    result = this->result;
+    available = false;
+    return true;
+}
+
+void SolvabilityChecker::run() {
+    const Solver solver;
+
+    for(;;) {
+        Solver::Problem current;
+
+        /* Wait for new problem */
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this]() { return pending || quit; });
+            if(quit) return;
+
+            current = std::move(problem);
+            pending = false;
+            cancelled = false;
+        }
+
+        Solver::Result currentResult = solver.solve(current, cancelled);
+
+        /* Publish the result, unless it's already stale */
+        std::lock_guard<std::mutex> lock(mutex);
+        if(currentResult.verdict != Solver::Verdict::Cancelled && !pending) {
+            result = std::move(currentResult);
+            available = true;
+        }
+    }
+}
+
+}}
@@ -0,0 +1,75 @@
+#ifndef PushTheBox_Editor_SolvabilityChecker_h
+#define PushTheBox_Editor_SolvabilityChecker_h
+
+/** @file
+ * @brief Class PushTheBox::Editor::SolvabilityChecker
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "Editor/Solver.h"
+
+namespace PushTheBox { namespace Editor {
+
+/**
+@brief Background solvability checker
+
+Runs @ref Solver on a worker thread. Submitting a new problem cancels the
+check currently in progress, so only the latest edit gets a verdict. Results
+are polled from the main thread with @ref fetch(), which never blocks on the
+solver.
+*/
+class SolvabilityChecker {
+    public:
+        /** @brief Constructor */
+        explicit SolvabilityChecker();
+
+        /** @brief Copying is not allowed */
+        SolvabilityChecker(const SolvabilityChecker&) = delete;
+
+        /**
+         * @brief Destructor
+         *
+         * Cancels the running check and waits for the worker thread to
+         * finish.
+         */
+        ~SolvabilityChecker();
+
+        /** @brief Copying is not allowed */
+        SolvabilityChecker& operator=(const SolvabilityChecker&) = delete;
+
+        /**
+         * @brief Check given level
+         *
+         * Replaces any pending problem, cancels the running check and
+         * discards result of the previous one, if not fetched yet.
+         */
+        void check(Solver::Problem problem);
+
+        /**
+         * @brief Fetch result of the latest finished check
+         * @return `True` if there was a new result since the last call,
+         *      `false` otherwise
+         */
+        bool fetch(Solver::Result& result);
+
+    private:
+        void run();
+
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::atomic<bool> cancelled;
+        bool quit, pending, available;
+        Solver::Problem problem;
+        Solver::Result result;
+
+        /* Must be last so it starts after everything above is initialized */
+        std::thread thread;
+};
+
+}}
+
+#endif
@@ -0,0 +1,266 @@
+#include "Solver.h"
+
+#include <algorithm>
+#include <sstream>
+#include <unordered_set>
+
+namespace PushTheBox { namespace Editor {
+
+namespace {
+
+typedef Game::Level::TileType TileType;
+
+inline bool isWalkable(TileType type) {
+    return type != TileType::Empty && type != TileType::Wall;
+}
+
+inline bool isTarget(TileType type) {
+    return type == TileType::Target || type == TileType::BoxOnTarget;
+}
+
+inline bool isBox(TileType type) {
+    return type == TileType::Box || type == TileType::BoxOnTarget;
+}
+
+/* Search state. Boxes are sorted cell indices, player is the smallest
+   reachable cell index so states differing only in player position inside
+   the same area compare equal. */
+struct State {
+    std::vector<Int> boxes;
+    Int player;
+
+    std::string key() const {
+        std::string out(reinterpret_cast<const char*>(boxes.data()), boxes.size()*sizeof(Int));
+        out.append(reinterpret_cast<const char*>(&player), sizeof(Int));
+        return out;
+    }
+};
+
+class Grid {
+    public:
+        explicit Grid(const Solver::Problem& problem): width(problem.size.x()), height(problem.size.y()), walkable(problem.tiles.size()), target(problem.tiles.size()), live(problem.tiles.size()) {
+            for(std::size_t i = 0; i != problem.tiles.size(); ++i) {
+                walkable[i] = isWalkable(problem.tiles[i]);
+                target[i] = isTarget(problem.tiles[i]);
+            }
+
+            const Int offsets[]{-1, 1, -width, width};
+            for(Int i = 0; i != 4; ++i) directions[i] = offsets[i];
+
+            computeLiveCells();
+        }
+
+        /* Neighbor in given direction or -1 if out of the map */
+        Int neighbor(Int cell, Int direction) const {
+            const Int x = cell%width;
+            if(direction == 0 && x == 0) return -1;
+            if(direction == 1 && x == width - 1) return -1;
+            const Int next = cell + directions[direction];
+            return next >= 0 && next < Int(walkable.size()) ? next : -1;
+        }
+
+        bool isFree(Int cell) const { return cell != -1 && walkable[cell]; }
+
+        Int width, height;
+        Int directions[4];
+        std::vector<bool> walkable, target, live;
+
+    private:
+        /* A cell is live if a box standing on it can be pushed to some
+           target. Computed by pulling boxes backwards from all targets. */
+        void computeLiveCells() {
+            std::vector<Int> queue;
+            for(std::size_t i = 0; i != target.size(); ++i) if(target[i]) {
+                live[i] = true;
+                queue.push_back(i);
+            }
+
+            for(std::size_t i = 0; i != queue.size(); ++i) for(Int d = 0; d != 4; ++d) {
+                /* Box got to queue[i] from `from` by a push in direction
+                   `d`, the player stood behind `from` */
+                const Int from = neighbor(queue[i], d^1);
+                if(!isFree(from) || live[from]) continue;
+                if(!isFree(neighbor(from, d^1))) continue;
+
+                live[from] = true;
+                queue.push_back(from);
+            }
+        }
+};
+
+/* Box which can't be moved anymore: box stuck in a 2x2 block of walls and
+   boxes where at least one of the boxes isn't on a target */
+bool isFrozenSquare(const Grid& grid, const std::vector<bool>& occupied, Int cell) {
+    const Int x = cell%grid.width, y = cell/grid.width;
+    for(Int dy = -1; dy <= 0; ++dy) for(Int dx = -1; dx <= 0; ++dx) {
+        if(x + dx < 0 || y + dy < 0 || x + dx + 1 >= grid.width || y + dy + 1 >= grid.height)
+            continue;
+
+        bool blocked = true, allOnTargets = true;
+        for(Int j = 0; j != 2 && blocked; ++j) for(Int i = 0; i != 2; ++i) {
+            const Int c = (y + dy + j)*grid.width + x + dx + i;
+            if(occupied[c]) {
+                if(!grid.target[c]) allOnTargets = false;
+            } else if(grid.walkable[c]) {
+                blocked = false;
+                break;
+            }
+        }
+
+        if(blocked && !allOnTargets) return true;
+    }
+
+    return false;
+}
+
+/* Flood-fill cells reachable by the player, returns smallest reachable cell */
+Int reachable(const Grid& grid, const std::vector<bool>& occupied, Int from, std::vector<bool>& visited, std::vector<Int>& queue) {
+    std::fill(visited.begin(), visited.end(), false);
+    queue.clear();
+    queue.push_back(from);
+    visited[from] = true;
+
+    Int smallest = from;
+    for(std::size_t i = 0; i != queue.size(); ++i) for(Int d = 0; d != 4; ++d) {
+        const Int next = grid.neighbor(queue[i], d);
+        if(!grid.isFree(next) || occupied[next] || visited[next]) continue;
+
+        visited[next] = true;
+        queue.push_back(next);
+        smallest = std::min(smallest, next);
+    }
+
+    return smallest;
+}
+
+}
+
+Solver::Result Solver::solve(const Problem& problem, const std::atomic<bool>& cancelled) const {
+    CORRADE_INTERNAL_ASSERT(std::size_t(problem.size.product()) == problem.tiles.size());
+
+    Result result{Verdict::Invalid, {}, 0, 0};
+
+    /* Sanity checks, the same as Level does on load */
+    if((problem.size < Vector2i(4, 4)).any()) {
+        result.message = "level is too small";
+        return result;
+    }
+
+    const Grid grid(problem);
+    const Int player = problem.playerPosition.y()*grid.width + problem.playerPosition.x();
+    if((problem.playerPosition < Vector2i()).any() || (problem.playerPosition >= problem.size).any() || !grid.walkable[player]) {
+        result.message = "no starting position";
+        return result;
+    }
+
+    State initial;
+    std::size_t targetCount = 0, remainingTargets = 0, deadBoxes = 0;
+    for(std::size_t i = 0; i != problem.tiles.size(); ++i) {
+        if(grid.target[i]) ++targetCount;
+        if(problem.tiles[i] == TileType::Target) ++remainingTargets;
+        if(isBox(problem.tiles[i])) {
+            initial.boxes.push_back(i);
+            if(!grid.live[i]) ++deadBoxes;
+        }
+    }
+
+    if(initial.boxes.size() != targetCount) {
+        std::ostringstream out;
+        out << initial.boxes.size() << " boxes, but " << targetCount << " targets";
+        result.message = out.str();
+        return result;
+    }
+
+    if(!remainingTargets) {
+        result.message = "level is already solved";
+        return result;
+    }
+
+    if(isBox(problem.tiles[player])) {
+        result.message = "player stands on a box";
+        return result;
+    }
+
+    if(deadBoxes) {
+        std::ostringstream out;
+        out << deadBoxes << (deadBoxes == 1 ? " box" : " boxes") << " can't reach any target";
+        result.verdict = Verdict::Deadlocked;
+        result.message = out.str();
+        return result;
+    }
+
+    /* Breadth-first search, one layer per push */
+    std::vector<bool> occupied(problem.tiles.size()), visited(problem.tiles.size()), nextVisited(problem.tiles.size());
+    std::vector<Int> queue;
+    for(Int box: initial.boxes) occupied[box] = true;
+    initial.player = reachable(grid, occupied, player, visited, queue);
+
+    std::unordered_set<std::string> seen{initial.key()};
+    std::vector<State> layer{initial}, nextLayer;
+    for(UnsignedInt pushes = 0; !layer.empty(); ++pushes) {
+        for(const State& state: layer) {
+            if(cancelled) {
+                result.verdict = Verdict::Cancelled;
+                return result;
+            }
+
+            if(seen.size() > _maxStates) {
+                result.verdict = Verdict::TooComplex;
+                result.message = "too many states to explore";
+                result.states = seen.size();
+                return result;
+            }
+
+            /* Goal state */
+            if(std::all_of(state.boxes.begin(), state.boxes.end(), [&grid](Int box) { return grid.target[box]; })) {
+                std::ostringstream out;
+                out << "solvable in " << pushes << (pushes == 1 ? " push" : " pushes");
+                result.verdict = Verdict::Solvable;
+                result.message = out.str();
+                result.pushes = pushes;
+                result.states = seen.size();
+                return result;
+            }
+
+            std::fill(occupied.begin(), occupied.end(), false);
+            for(Int box: state.boxes) occupied[box] = true;
+            reachable(grid, occupied, state.player, visited, queue);
+
+            /* Try all possible pushes */
+            for(std::size_t b = 0; b != state.boxes.size(); ++b) for(Int d = 0; d != 4; ++d) {
+                const Int box = state.boxes[b];
+                const Int from = grid.neighbor(box, d^1);
+                const Int to = grid.neighbor(box, d);
+                if(from == -1 || !visited[from] || !grid.isFree(to) || occupied[to] || !grid.live[to])
+                    continue;
+
+                occupied[box] = false;
+                occupied[to] = true;
+                if(!isFrozenSquare(grid, occupied, to)) {
+                    State next;
+                    next.boxes = state.boxes;
+                    next.boxes[b] = to;
+                    std::sort(next.boxes.begin(), next.boxes.end());
+
+                    /* Player ends up where the box was */
+                    next.player = reachable(grid, occupied, box, nextVisited, queue);
+
+                    if(seen.insert(next.key()).second)
+                        nextLayer.push_back(std::move(next));
+                }
+                occupied[to] = false;
+                occupied[box] = true;
+            }
+        }
+
+        std::swap(layer, nextLayer);
+        nextLayer.clear();
+    }
+
+    result.verdict = Verdict::Unsolvable;
+    result.message = "no solution exists";
+    result.states = seen.size();
+    return result;
+}
+
+}}
@@ -0,0 +1,74 @@
+#ifndef PushTheBox_Editor_Solver_h
+#define PushTheBox_Editor_Solver_h
+
+/** @file
+ * @brief Class PushTheBox::Editor::Solver
+ */
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <Magnum/Math/Vector2.h>
+
+#include "PushTheBox.h"
+#include "Game/Level.h"
+
+namespace PushTheBox { namespace Editor {
+
+/**
+@brief Level solver
+
+Breadth-first search over box configurations, with the player position
+normalized to the top-left-most reachable cell. Pushes into dead squares
+(from which the box can never reach any target) and simple 2x2 freeze
+deadlocks are pruned. The search has an upper bound on explored states so
+hopelessly large levels don't hang the checker forever.
+*/
+class Solver {
+    public:
+        /** @brief Verdict */
+        enum class Verdict: UnsignedByte {
+            Invalid,        /**< Level is malformed */
+            Deadlocked,     /**< A box is already stuck */
+            Unsolvable,     /**< No sequence of pushes solves the level */
+            Solvable,       /**< Level can be solved */
+            TooComplex,     /**< State limit reached before the answer */
+            Cancelled       /**< Search was cancelled from outside */
+        };
+
+        /** @brief Level to solve */
+        struct Problem {
+            Vector2i size;
+            std::vector<Game::Level::TileType> tiles;
+            Vector2i playerPosition;
+        };
+
+        /** @brief Solver result */
+        struct Result {
+            Verdict verdict;
+            std::string message;    /**< Human-readable explanation */
+            UnsignedInt pushes;     /**< Minimal push count, if solvable */
+            std::size_t states;     /**< Count of explored states */
+        };
+
+        /**
+         * @brief Constructor
+         * @param maxStates     Upper bound on explored states
+         */
+        explicit Solver(std::size_t maxStates = 500000): _maxStates(maxStates) {}
+
+        /**
+         * @brief Solve the level
+         * @param problem       Level to solve
+         * @param cancelled     Polled regularly, the search returns
+         *      @ref Verdict::Cancelled as soon as it becomes `true`
+         */
+        Result solve(const Problem& problem, const std::atomic<bool>& cancelled) const;
+
+    private:
+        std::size_t _maxStates;
+};
+
+}}
+
+#endif
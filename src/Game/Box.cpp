@@ -2,45 +2,69 @@
 
 #include <Magnum/Buffer.h>
 #include <Magnum/Mesh.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Range.h>
 #include <Magnum/SceneGraph/AbstractCamera.h>
-#include <Magnum/Shaders/Phong.h>
+
+#include "Application.h"
+#include "Game/Camera.h"
+#include "Game/InstanceBatch.h"
+#include "Shaders/CachedPhong.h"
 
 namespace PushTheBox { namespace Game {
 
 namespace {
     static const Color3 on = Color3::fromHsv(Deg(120.0f), 1.0f, 0.6f);
     static const Color3 off = Color3::fromHsv(Deg(0.0f), 1.0f, 0.6f);
+
+    /* Slightly larger than the box mesh */
+    const Range3D bounds{{-0.5f, -0.05f, -0.5f}, {0.5f, 0.65f, 0.5f}};
 }
 
-Box::Box(const Vector2i& position, Type type, Object3D* parent, SceneGraph::DrawableGroup3D* drawables, SceneGraph::AnimableGroup3D* animables): Object3D(parent), SceneGraph::Drawable3D(*this, drawables), SceneGraph::Animable3D(*this, animables), position(position), type(type), color(type == Type::OnFloor ? off : on) {
-    shader = SceneResourceManager::instance().get<AbstractShaderProgram, Shaders::Phong>("phong");
-    mesh = SceneResourceManager::instance().get<Mesh>("box-mesh");
+Color3 Box::color(const Type type) {
+    return type == Type::OnFloor ? off : on;
+}
 
+Box::Box(const Vector2i& position, Type type, Object3D* parent, SceneGraph::DrawableGroup3D* drawables, InstanceBatch* batch): Object3D(parent), SceneGraph::Drawable3D(*this, batch ? nullptr : drawables), lodCount(1), currentLod(0), position(position), _color(color(type)), batch(batch) {
     translate(Math::swizzle<'x', '0', 'y'>(Vector2(position)));
-    setDuration(0.375f);
 
-    Interconnect::connect(*this, &Box::movedToTarget, *this, &Box::animateMoveFromToTarget);
-    Interconnect::connect(*this, &Box::movedFromTarget, *this, &Box::animateMoveFromToTarget);
+    /* Drawn by the batch */
+    if(batch) instanceId = batch->add(transformationMatrix(), _color);
+    else {
+        shader = SceneResourceManager::instance().get<AbstractShaderProgram, Shaders::CachedPhong>("phong");
+        meshes[0] = SceneResourceManager::instance().get<Mesh>("box-mesh");
+        for(const char* const name: {"box-mesh-lod1", "box-mesh-lod2"}) {
+            if(!Application::instance()->meshResourceLoader().contains(name)) break;
+            meshes[lodCount++] = SceneResourceManager::instance().get<Mesh>(name);
+        }
+    }
 }
 
-void Box::draw(const Matrix4& transformationMatrix, SceneGraph::Camera3D&) {
-    shader->setTransformationMatrix(transformationMatrix)
-          /** @todo rotationNormalized() when precision problems are fixed */
-          .setNormalMatrix(transformationMatrix.rotationScaling())
-          .setDiffuseColor(color);
+void Box::set(const Vector2i& position, const Color3& color) {
+    if(position == this->position && color == _color) return;
 
-    mesh->draw(*shader);
+    translate(Math::swizzle<'x', '0', 'y'>(Vector2(position - this->position)));
+    this->position = position;
+    _color = color;
+    if(batch) batch->set(instanceId, transformationMatrix(), _color);
 }
 
-void Box::animationStep(Float time, Float) {
-    if(type == Type::OnFloor)
-        color = Math::lerp(on, off, time/duration());
-    else
-        color = Math::lerp(off, on, time/duration());
+void Box::draw(const Matrix4& transformationMatrix, SceneGraph::Camera3D& camera) {
+    if(!static_cast<Camera&>(camera).isVisible(transformationMatrix, bounds)) return;
+
+    const Float distance = transformationMatrix.translation().length();
+    currentLod = Math::min(Camera::levelOfDetail(distance), lodCount - 1);
+    drawTransformation = transformationMatrix;
+    Application::instance()->renderQueue().addOpaque(*shader, *meshes[currentLod], Rendering::RenderQueue::material(_color), *this, drawTransformation, distance);
 }
 
-void Box::animationStopped() {
-    color = type == Type::OnFloor ? off : on;
+UnsignedInt Box::submit(UnsignedInt, bool) {
+    const UnsignedInt uploadCount = shader->uploadCount();
+    shader->setTransformation(drawTransformation)
+          .setDiffuseColor(_color);
+
+    meshes[currentLod]->draw(*shader);
+    return shader->uploadCount() - uploadCount;
 }
 
 }}
@@ -5,69 +5,74 @@
  * @brief Class PushTheBox::Game::Box
  */
 
-#include <Corrade/Interconnect/Emitter.h>
-#include <Corrade/Interconnect/Receiver.h>
 #include <Magnum/Color.h>
 #include <Magnum/ResourceManager.h>
-#include <Magnum/SceneGraph/Animable.h>
 #include <Magnum/SceneGraph/Drawable.h>
 #include <Magnum/SceneGraph/DualQuaternionTransformation.h>
-#include <Magnum/Shaders/Shaders.h>
 
 #include "PushTheBox.h"
+#include "Rendering/RenderQueue.h"
 
-namespace PushTheBox { namespace Game {
+namespace PushTheBox {
 
-/** @brief %Box */
-class Box: public Object3D, public SceneGraph::Drawable3D, public SceneGraph::Animable3D, public Interconnect::Emitter, public Interconnect::Receiver {
-    friend class Level;
+namespace Shaders {
+    class CachedPhong;
+}
 
+namespace Game {
+
+class InstanceBatch;
+
+/**
+@brief %Box
+
+If instance batch is given, the box is drawn as part of it instead of
+separately. Otherwise the box uses simplified versions of its mesh when far
+away from the camera. The box is only drawn, it's moved and its color is
+animated by the simulation.
+*/
+class Box: public Object3D, public SceneGraph::Drawable3D, Rendering::RenderQueue::Renderable {
     public:
         enum class Type {
             OnFloor,
             OnTarget
         };
 
+        /** @brief Color of box of given type */
+        static Color3 color(Type type);
+
         /**
          * @brief Constructor
          * @param position  Initial position in level
          * @param type      Box type
          * @param parent    Parent object
          * @param drawables Drawable group
-         * @param animables Animable group
+         * @param batch     Instance batch or `nullptr`
          */
-        Box(const Vector2i& position, Type type, Object3D* parent = nullptr, SceneGraph::DrawableGroup3D* drawables = nullptr, SceneGraph::AnimableGroup3D* animables = nullptr);
-
-        /** @brief Box was moved to target */
-        inline Signal movedToTarget() {
-            return emit(&Box::movedToTarget);
-        }
+        Box(const Vector2i& position, Type type, Object3D* parent = nullptr, SceneGraph::DrawableGroup3D* drawables = nullptr, InstanceBatch* batch = nullptr);
 
-        /** @brief Box was moved from target */
-        inline Signal movedFromTarget() {
-            return emit(&Box::movedFromTarget);
-        }
+        /**
+         * @brief Move and recolor the box
+         *
+         * Does nothing if neither the position nor the color changed.
+         */
+        void set(const Vector2i& position, const Color3& color);
 
     protected:
         /** @seemagnum{SceneGraph::Drawable::draw()} */
         void draw(const Matrix4& transformationMatrix, SceneGraph::Camera3D& camera) override;
 
-        /** @seemagnum{SceneGraph::Animable::animationStep()} */
-        void animationStep(Float time, Float delta) override;
-
-        /** @seemagnum{SceneGraph::Animable::animationStopped()} */
-        void animationStopped() override;
-
     private:
-        inline void animateMoveFromToTarget() {
-            setState(SceneGraph::AnimationState::Running);
-        }
+        UnsignedInt submit(UnsignedInt part, bool materialChanged) override;
 
-        Resource<AbstractShaderProgram, Shaders::Phong> shader;
-        Resource<Mesh> mesh;
+        Resource<AbstractShaderProgram, Shaders::CachedPhong> shader;
+        Resource<Mesh> meshes[3];
+        UnsignedInt lodCount, currentLod;
         Vector2i position;
-        Type type;
-        Color3 color;
+        Color3 _color;
+        Matrix4 drawTransformation;
+        InstanceBatch* batch;
+        std::size_t instanceId;
 };
 
 }}
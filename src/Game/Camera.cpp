@@ -1,19 +1,118 @@
 #include "Camera.h"
 
+#include <Corrade/Containers/ArrayView.h>
 #include <Magnum/Buffer.h>
 #include <Magnum/Context.h>
 #include <Magnum/DefaultFramebuffer.h>
 #include <Magnum/Extensions.h>
+#include <Magnum/Framebuffer.h>
 #include <Magnum/Mesh.h>
 #include <Magnum/Renderbuffer.h>
 #include <Magnum/RenderbufferFormat.h>
 #include <Magnum/Renderer.h>
 #include <Magnum/ResourceManager.h>
+#include <Magnum/Texture.h>
 #include <Magnum/TextureFormat.h>
+#ifndef MAGNUM_TARGET_WEBGL
+#include <Magnum/TimeQuery.h>
+#endif
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Range.h>
+
+#include "Application.h"
+#include "Rendering/CpuProfiler.h"
 
 namespace PushTheBox { namespace Game {
 
-Camera::Camera(Object3D* parent): Object3D(parent), SceneGraph::Camera3D(*this), _blurred(true), multisampleFramebuffer({{}, defaultFramebuffer.viewport().size()/8}), framebuffer1(multisampleFramebuffer.viewport()), framebuffer2(multisampleFramebuffer.viewport()), blurShaderHorizontal(Shaders::Blur::Direction::Horizontal), blurShaderVertical(Shaders::Blur::Direction::Vertical) {
+namespace {
+    TextureFormat blurTextureFormat() {
+        #ifdef MAGNUM_TARGET_GLES2
+        if(!Context::current()->isExtensionSupported<Extensions::GL::OES::required_internalformat>())
+            return TextureFormat::RGB;
+        #endif
+        return TextureFormat::RGB8;
+    }
+
+    /* ES2 devices without multisampled framebuffers are usually the weak
+       ones, use a cheaper blur there */
+    Shaders::Blur::Quality blurQuality() {
+        #ifdef MAGNUM_TARGET_GLES2
+        if(!Context::current()->isExtensionSupported<Extensions::GL::ANGLE::framebuffer_multisample>() &&
+           !Context::current()->isExtensionSupported<Extensions::GL::NV::framebuffer_multisample>())
+            return Shaders::Blur::Quality::Low;
+        #endif
+        return Shaders::Blur::Quality::High;
+    }
+}
+
+/* Offscreen targets for the blur, all at 1/8 of the viewport size except
+   for the pyramid levels */
+struct Camera::BlurTargets {
+    struct Level {
+        explicit Level(Texture2D& texture, const Vector2i& size): texture(texture), framebuffer({{}, size}) {}
+
+        Texture2D& texture;
+        Framebuffer framebuffer;
+    };
+
+    explicit BlurTargets(const Vector2i& size): multisampleFramebuffer({{}, size}), framebuffer1({{}, size}), framebuffer2({{}, size}) {}
+
+    Renderbuffer *multisampleColor{}, *multisampleDepth{}, *depth{};
+    Texture2D *texture1{}, *texture2{};
+    Framebuffer multisampleFramebuffer, framebuffer1, framebuffer2;
+    std::unique_ptr<Level> levels[2];
+};
+
+/* Scene rendered at reduced resolution, upscaled to the target framebuffer */
+struct Camera::SceneTargets {
+    explicit SceneTargets(const Vector2i& size): framebuffer({{}, size}) {}
+
+    Texture2D* color{};
+    Renderbuffer* depth{};
+    Framebuffer framebuffer;
+};
+
+/* GPU time of the scene pass for dynamic resolution. Timestamps are used
+   instead of time elapsed queries, which can't be nested in the GPU profiler
+   passes. Results are read a few frames later so the CPU never waits for
+   them, results not available even then are dropped. */
+struct Camera::SceneTimer {
+    enum: std::size_t { Latency = 3 };
+
+    explicit SceneTimer() {
+        #ifndef MAGNUM_TARGET_WEBGL
+        for(std::size_t i = 0; i != Latency*2; ++i)
+            queries.emplace_back(TimeQuery::Target::Timestamp);
+        #endif
+    }
+
+    void begin() {
+        #ifndef MAGNUM_TARGET_WEBGL
+        /* Collect the oldest frame before its queries are reused */
+        if(issued[current] && queries[current*2 + 1].resultAvailable())
+            duration = (queries[current*2 + 1].result<UnsignedLong>() - queries[current*2].result<UnsignedLong>())/1.0e9f;
+        issued[current] = false;
+        queries[current*2].timestamp();
+        #endif
+    }
+
+    void end() {
+        #ifndef MAGNUM_TARGET_WEBGL
+        queries[current*2 + 1].timestamp();
+        issued[current] = true;
+        current = (current + 1) % Latency;
+        #endif
+    }
+
+    #ifndef MAGNUM_TARGET_WEBGL
+    std::vector<TimeQuery> queries;
+    #endif
+    bool issued[Latency]{};
+    std::size_t current{};
+    Float duration{};
+};
+
+Camera::Camera(Object3D* parent): Object3D(parent), SceneGraph::Camera3D(*this), _blurred(true), _blurCached(false), _dynamicResolution(false), blurSampleCount(16), _blurMode(BlurMode::Gaussian), _drawnCount(0), _culledCount(0), _framebuffer(&defaultFramebuffer), blurShaderHorizontal(Shaders::Blur::Direction::Horizontal, blurQuality()), blurShaderVertical(Shaders::Blur::Direction::Vertical, blurQuality()) {
     /* Get full screen triangle */
     fullScreenTriangleBuffer = SceneResourceManager::instance().get<Buffer>("fullscreentriangle");
     fullScreenTriangle = SceneResourceManager::instance().get<Mesh>("fullscreentriangle");
@@ -37,102 +136,349 @@ Camera::Camera(Object3D* parent): Object3D(parent), SceneGraph::Camera3D(*this),
     _multisample = true;
     #endif
 
-    /* Configure depth buffer */
-    RenderbufferFormat depthFormat = RenderbufferFormat::DepthComponent24;
+    /* Decide about depth buffer format */
+    depthFormat = RenderbufferFormat::DepthComponent24;
     #ifdef MAGNUM_TARGET_GLES2
     if(!Context::current()->isExtensionSupported<Extensions::GL::OES::depth24>()) {
         Debug() << Extensions::GL::OES::depth24::string() << "not supported, fallback to 16bit depth buffer";
         depthFormat = RenderbufferFormat::DepthComponent16;
     }
+    if(_multisample) MAGNUM_ASSERT_EXTENSION_SUPPORTED(Extensions::GL::OES::rgb8_rgba8);
     #endif
-    depth.setStorage(depthFormat, multisampleFramebuffer.viewport().size());
-    framebuffer1.attachRenderbuffer(Framebuffer::BufferAttachment::Depth, depth);
-    framebuffer2.attachRenderbuffer(Framebuffer::BufferAttachment::Depth, depth);
+}
 
-    /* Configure multisample framebuffer */
-    if(_multisample) {
-        #ifdef MAGNUM_TARGET_GLES2
-        MAGNUM_ASSERT_EXTENSION_SUPPORTED(Extensions::GL::OES::rgb8_rgba8);
-        #endif
-        multisampleColor.setStorageMultisample(16, RenderbufferFormat::RGBA8, multisampleFramebuffer.viewport().size());
-        multsampleDepth.setStorageMultisample(16, depthFormat, multisampleFramebuffer.viewport().size());
-        multisampleFramebuffer.attachRenderbuffer(Framebuffer::ColorAttachment(0), multisampleColor);
-        multisampleFramebuffer.attachRenderbuffer(Framebuffer::BufferAttachment::Depth, multsampleDepth);
-        CORRADE_INTERNAL_ASSERT(multisampleFramebuffer.checkStatus(FramebufferTarget::Read) == Framebuffer::Status::Complete);
-        CORRADE_INTERNAL_ASSERT(multisampleFramebuffer.checkStatus(FramebufferTarget::Draw) == Framebuffer::Status::Complete);
+Camera::~Camera() {
+    releaseBlurTargets();
+    releaseSceneTargets();
+}
+
+void Camera::acquireBlurTargets() {
+    Rendering::RenderTargetPool& pool = Application::instance()->renderTargetPool();
+    const Vector2i size = Math::max(viewport()/8, Vector2i{1});
+    blurTargets.reset(new BlurTargets(size));
+    BlurTargets& t = *blurTargets;
+
+    /* Multisample framebuffer */
+    if(_multisample && blurSampleCount) {
+        t.multisampleColor = &pool.acquireRenderbuffer(RenderbufferFormat::RGBA8, size, blurSampleCount);
+        t.multisampleDepth = &pool.acquireRenderbuffer(depthFormat, size, blurSampleCount);
+        t.multisampleFramebuffer.attachRenderbuffer(Framebuffer::ColorAttachment(0), *t.multisampleColor)
+            .attachRenderbuffer(Framebuffer::BufferAttachment::Depth, *t.multisampleDepth);
+        CORRADE_INTERNAL_ASSERT(t.multisampleFramebuffer.checkStatus(FramebufferTarget::Read) == Framebuffer::Status::Complete);
+        CORRADE_INTERNAL_ASSERT(t.multisampleFramebuffer.checkStatus(FramebufferTarget::Draw) == Framebuffer::Status::Complete);
     }
 
-    /* Configure textures */
-    TextureFormat internalFormat = TextureFormat::RGB8;
-    #ifdef MAGNUM_TARGET_GLES2
-    if(!Context::current()->isExtensionSupported<Extensions::GL::OES::required_internalformat>())
-        internalFormat = TextureFormat::RGB;
-    #endif
-    texture1.setStorage(1, internalFormat, multisampleFramebuffer.viewport().size())
-        .setMagnificationFilter(Sampler::Filter::Linear)
-        .setMinificationFilter(Sampler::Filter::Nearest)
+    /* Textures, both blurs rely on bilinear filtering */
+    t.depth = &pool.acquireRenderbuffer(depthFormat, size);
+    t.texture1 = &pool.acquireTexture(blurTextureFormat(), size);
+    t.texture2 = &pool.acquireTexture(blurTextureFormat(), size);
+    for(Texture2D* texture: {t.texture1, t.texture2}) texture->setMagnificationFilter(Sampler::Filter::Linear)
+        .setMinificationFilter(Sampler::Filter::Linear)
         .setWrapping(Sampler::Wrapping::ClampToEdge);
-    texture2.setStorage(1, internalFormat, multisampleFramebuffer.viewport().size())
-        .setMagnificationFilter(Sampler::Filter::Linear)
-        .setMinificationFilter(Sampler::Filter::Nearest)
+    t.framebuffer1.attachTexture(Framebuffer::ColorAttachment(0), *t.texture1, 0)
+        .attachRenderbuffer(Framebuffer::BufferAttachment::Depth, *t.depth);
+    t.framebuffer2.attachTexture(Framebuffer::ColorAttachment(0), *t.texture2, 0)
+        .attachRenderbuffer(Framebuffer::BufferAttachment::Depth, *t.depth);
+    CORRADE_INTERNAL_ASSERT(t.framebuffer1.checkStatus(FramebufferTarget::Read) == Framebuffer::Status::Complete);
+    CORRADE_INTERNAL_ASSERT(t.framebuffer1.checkStatus(FramebufferTarget::Draw) == Framebuffer::Status::Complete);
+    CORRADE_INTERNAL_ASSERT(t.framebuffer2.checkStatus(FramebufferTarget::Read) == Framebuffer::Status::Complete);
+    CORRADE_INTERNAL_ASSERT(t.framebuffer2.checkStatus(FramebufferTarget::Draw) == Framebuffer::Status::Complete);
+
+    blurShaderHorizontal.setImageSizeInverted(1.0f/Vector2(size));
+    blurShaderVertical.setImageSizeInverted(1.0f/Vector2(size));
+
+    /* Each pyramid level is half the size of the previous one, no depth
+       buffer needed */
+    if(_blurMode == BlurMode::DualFilter) {
+        Vector2i levelSize = size;
+        for(std::unique_ptr<BlurTargets::Level>& level: t.levels) {
+            levelSize = Math::max(levelSize/2, Vector2i{1});
+            Texture2D& texture = pool.acquireTexture(blurTextureFormat(), levelSize);
+            texture.setMagnificationFilter(Sampler::Filter::Linear)
+                .setMinificationFilter(Sampler::Filter::Linear)
+                .setWrapping(Sampler::Wrapping::ClampToEdge);
+            level.reset(new BlurTargets::Level(texture, levelSize));
+            level->framebuffer.attachTexture(Framebuffer::ColorAttachment(0), texture, 0);
+            CORRADE_INTERNAL_ASSERT(level->framebuffer.checkStatus(FramebufferTarget::Draw) == Framebuffer::Status::Complete);
+        }
+    }
+}
+
+void Camera::releaseBlurTargets() {
+    if(!blurTargets) return;
+
+    Rendering::RenderTargetPool& pool = Application::instance()->renderTargetPool();
+    BlurTargets& t = *blurTargets;
+    if(t.multisampleColor) pool.release(*t.multisampleColor);
+    if(t.multisampleDepth) pool.release(*t.multisampleDepth);
+    pool.release(*t.depth);
+    pool.release(*t.texture1);
+    pool.release(*t.texture2);
+    for(std::unique_ptr<BlurTargets::Level>& level: t.levels)
+        if(level) pool.release(level->texture);
+
+    blurTargets = nullptr;
+    _blurCached = false;
+}
+
+void Camera::acquireSceneTargets() {
+    Rendering::RenderTargetPool& pool = Application::instance()->renderTargetPool();
+    const Float scale = _dynamicResolution ? _resolutionScaler.scale() : 1.0f;
+    const Vector2i size = Math::max(Vector2i(Vector2(viewport())*scale), Vector2i{1});
+    sceneTargets.reset(new SceneTargets(size));
+    SceneTargets& t = *sceneTargets;
+
+    /* Bilinear filtering for the upscale and FXAA */
+    t.color = &pool.acquireTexture(blurTextureFormat(), size);
+    t.color->setMagnificationFilter(Sampler::Filter::Linear)
+        .setMinificationFilter(Sampler::Filter::Linear)
         .setWrapping(Sampler::Wrapping::ClampToEdge);
-    framebuffer1.attachTexture(Framebuffer::ColorAttachment(0), texture1, 0);
-    framebuffer2.attachTexture(Framebuffer::ColorAttachment(0), texture2, 0);
+    t.depth = &pool.acquireRenderbuffer(depthFormat, size);
+    t.framebuffer.attachTexture(Framebuffer::ColorAttachment(0), *t.color, 0)
+        .attachRenderbuffer(Framebuffer::BufferAttachment::Depth, *t.depth);
+    CORRADE_INTERNAL_ASSERT(t.framebuffer.checkStatus(FramebufferTarget::Draw) == Framebuffer::Status::Complete);
+
+    if(fxaaShader) fxaaShader->setImageSizeInverted(1.0f/Vector2(size));
+}
 
-    /* Verify that everything is sane */
-    CORRADE_INTERNAL_ASSERT(framebuffer1.checkStatus(FramebufferTarget::Read) == Framebuffer::Status::Complete);
-    CORRADE_INTERNAL_ASSERT(framebuffer1.checkStatus(FramebufferTarget::Draw) == Framebuffer::Status::Complete);
-    CORRADE_INTERNAL_ASSERT(framebuffer2.checkStatus(FramebufferTarget::Read) == Framebuffer::Status::Complete);
-    CORRADE_INTERNAL_ASSERT(framebuffer2.checkStatus(FramebufferTarget::Draw) == Framebuffer::Status::Complete);
+void Camera::releaseSceneTargets() {
+    if(!sceneTargets) return;
+
+    Rendering::RenderTargetPool& pool = Application::instance()->renderTargetPool();
+    pool.release(*sceneTargets->color);
+    pool.release(*sceneTargets->depth);
+    sceneTargets = nullptr;
 }
 
 void Camera::setViewport(const Vector2i& size) {
     SceneGraph::Camera3D::setViewport(size);
 
-    multisampleFramebuffer.setViewport({{}, size/8});
-    framebuffer1.setViewport({{}, size/8});
-    framebuffer2.setViewport({{}, size/8});
-    /** @todo resize also texture */
+    /* Reallocated with the new size on next draw, targets of the old size
+       won't be needed anymore */
+    releaseBlurTargets();
+    releaseSceneTargets();
+    Application::instance()->renderTargetPool().trim();
+}
+
+void Camera::setFxaa(bool enabled) {
+    if(enabled && !fxaaShader)
+        fxaaShader.reset(new Shaders::Fxaa);
+    else if(!enabled) fxaaShader = nullptr;
+
+    /* Set up the size uniform again */
+    releaseSceneTargets();
+}
+
+void Camera::setBlurSampleCount(Int count) {
+    blurSampleCount = count;
+    releaseBlurTargets();
+}
+
+void Camera::setDynamicResolution(bool enabled) {
+    _dynamicResolution = enabled;
+    _resolutionScaler.reset();
+    releaseSceneTargets();
+
+    if(enabled && Rendering::GpuProfiler::isSupported()) {
+        if(!sceneTimer) sceneTimer.reset(new SceneTimer);
+    } else sceneTimer = nullptr;
+}
+
+void Camera::addFrameDuration(Float duration) {
+    if(!_dynamicResolution) return;
+
+    /* The GPU time is from a few frames ago, but it's the best estimate
+       of the GPU load there is */
+    if(sceneTimer) duration = Math::max(duration, sceneTimer->duration);
+
+    /* Targets with new size are acquired on next draw */
+    if(_resolutionScaler.addFrame(duration)) releaseSceneTargets();
+}
+
+void Camera::setBlurMode(BlurMode mode) {
+    _blurMode = mode;
+    releaseBlurTargets();
+
+    if(mode == BlurMode::DualFilter && !downsampleShader) {
+        downsampleShader.reset(new Shaders::DualFilterBlur(Shaders::DualFilterBlur::Pass::Downsample));
+        upsampleShader.reset(new Shaders::DualFilterBlur(Shaders::DualFilterBlur::Pass::Upsample));
+    }
+}
+
+void Camera::setBlurred(bool blurred) {
+    /* Nothing to cache anymore, the targets stay in the pool for the next
+       pause */
+    if(!blurred) releaseBlurTargets();
+
+    _blurred = blurred;
+}
+
+UnsignedInt Camera::levelOfDetail(Float distance) {
+    /* Bevels on the walls and boxes disappear at around these distances */
+    constexpr Float distances[]{8.0f, 16.0f};
+
+    UnsignedInt lod = 0;
+    while(lod != Containers::arraySize(distances) && distance > distances[lod]) ++lod;
+    return lod;
+}
+
+bool Camera::isVisible(const Matrix4& transformationMatrix, const Range3D& bounds) {
+    const Matrix4 matrix = projectionMatrix()*transformationMatrix;
+
+    /* The box is outside if all its corners are outside of the same plane */
+    UnsignedByte outside = 0x3f;
+    for(UnsignedInt i = 0; i != 8; ++i) {
+        const Vector4 corner = matrix*Vector4{
+            (i & 1 ? bounds.max() : bounds.min()).x(),
+            (i & 2 ? bounds.max() : bounds.min()).y(),
+            (i & 4 ? bounds.max() : bounds.min()).z(), 1.0f};
+
+        UnsignedByte planes = 0;
+        if(corner.x() < -corner.w()) planes |= 1 << 0;
+        if(corner.x() >  corner.w()) planes |= 1 << 1;
+        if(corner.y() < -corner.w()) planes |= 1 << 2;
+        if(corner.y() >  corner.w()) planes |= 1 << 3;
+        if(corner.z() < -corner.w()) planes |= 1 << 4;
+        if(corner.z() >  corner.w()) planes |= 1 << 5;
 
-    blurShaderHorizontal.setImageSizeInverted(8.0f/Vector2(size));
-    blurShaderVertical.setImageSizeInverted(8.0f/Vector2(size));
+        if(!(outside &= planes)) break;
+    }
+
+    ++(outside ? _culledCount : _drawnCount);
+    return !outside;
 }
 
 void Camera::draw(SceneGraph::DrawableGroup3D& group) {
+    PUSHTHEBOX_PROFILE_SCOPE("Camera::draw");
+    _drawnCount = _culledCount = 0;
+    Rendering::GpuProfiler& profiler = Application::instance()->gpuProfiler();
+
     /* Render the scene normally */
-    if(!_blurred) {
-        defaultFramebuffer.bind();
+    if(!_blurred && !fxaaShader && (!_dynamicResolution || _resolutionScaler.scale() >= 1.0f)) {
+        Rendering::GpuProfiler::Scope scope(profiler, "scene");
+        if(sceneTimer) sceneTimer->begin();
+        _framebuffer->bind();
         SceneGraph::Camera3D::draw(group);
+        Application::instance()->renderQueue().flush(projectionMatrix());
+        if(sceneTimer) sceneTimer->end();
+        return;
+    }
+
+    /* Render the scene offscreen and upscale it or filter it with FXAA */
+    if(!_blurred) {
+        if(!sceneTargets) acquireSceneTargets();
+
+        {
+            Rendering::GpuProfiler::Scope scope(profiler, "scene");
+            if(sceneTimer) sceneTimer->begin();
+            sceneTargets->framebuffer.bind();
+            sceneTargets->framebuffer.clear(FramebufferClear::Color|FramebufferClear::Depth);
+            SceneGraph::Camera3D::draw(group);
+            Application::instance()->renderQueue().flush(projectionMatrix());
+            if(sceneTimer) sceneTimer->end();
+        }
+
+        Rendering::GpuProfiler::Scope scope(profiler, fxaaShader ? "fxaa" : "upscale");
+        _framebuffer->bind();
+        _framebuffer->clear(FramebufferClear::Depth);
+        if(fxaaShader) {
+            fxaaShader->setTexture(*sceneTargets->color);
+            fullScreenTriangle->draw(*fxaaShader);
+        } else {
+            blurredShader.setTexture(*sceneTargets->color);
+            fullScreenTriangle->draw(blurredShader);
+        }
+        return;
+    }
+
+    /* The scene doesn't change while blurred, just display the cached
+       result */
+    if(_blurCached) {
+        Rendering::GpuProfiler::Scope scope(profiler, "blurred copy");
+        _framebuffer->bind();
+        _framebuffer->clear(FramebufferClear::Depth);
+        blurredShader.setTexture(*blurTargets->texture1);
+        fullScreenTriangle->draw(blurredShader);
         return;
     }
 
+    if(!blurTargets) acquireBlurTargets();
+    BlurTargets& t = *blurTargets;
+
     /* Draw scene to multisampled framebuffer */
-    if(_multisample) {
-        multisampleFramebuffer.bind();
-        multisampleFramebuffer.clear(FramebufferClear::Color|FramebufferClear::Depth);
-        SceneGraph::Camera3D::draw(group);
+    if(_multisample && blurSampleCount) {
+        {
+            Rendering::GpuProfiler::Scope scope(profiler, "blurred scene");
+            t.multisampleFramebuffer.bind();
+            t.multisampleFramebuffer.clear(FramebufferClear::Color|FramebufferClear::Depth);
+            SceneGraph::Camera3D::draw(group);
+            Application::instance()->renderQueue().flush(projectionMatrix());
+        }
 
         /* Resolve to first texture */
-        Framebuffer::blit(multisampleFramebuffer, framebuffer1, multisampleFramebuffer.viewport(), FramebufferBlit::Color);
+        Rendering::GpuProfiler::Scope scope(profiler, "resolve");
+        Framebuffer::blit(t.multisampleFramebuffer, t.framebuffer1, t.multisampleFramebuffer.viewport(), FramebufferBlit::Color);
 
     /* Single sample fallback */
     } else {
-        framebuffer1.bind();
-        framebuffer1.clear(FramebufferClear::Color|FramebufferClear::Depth);
+        Rendering::GpuProfiler::Scope scope(profiler, "blurred scene");
+        t.framebuffer1.bind();
+        t.framebuffer1.clear(FramebufferClear::Color|FramebufferClear::Depth);
         SceneGraph::Camera3D::draw(group);
+        Application::instance()->renderQueue().flush(projectionMatrix());
+    }
+
+    /* Downsample the first texture through the pyramid and upsample it back */
+    if(_blurMode == BlurMode::DualFilter) {
+        Rendering::GpuProfiler::Scope scope(profiler, "dual filter blur");
+        Texture2D* source = t.texture1;
+        Vector2i sourceSize = t.framebuffer1.viewport().size();
+        for(std::unique_ptr<BlurTargets::Level>& level: t.levels) {
+            level->framebuffer.bind();
+            downsampleShader->setImageSizeInverted(1.0f/Vector2(sourceSize))
+                .setTexture(*source);
+            fullScreenTriangle->draw(*downsampleShader);
+            source = &level->texture;
+            sourceSize = level->framebuffer.viewport().size();
+        }
+
+        for(std::size_t i = Containers::arraySize(t.levels); i != 0; --i) {
+            if(i == 1) {
+                t.framebuffer1.bind();
+                t.framebuffer1.clear(FramebufferClear::Depth);
+            } else t.levels[i - 2]->framebuffer.bind();
+            upsampleShader->setImageSizeInverted(1.0f/Vector2(t.levels[i - 1]->framebuffer.viewport().size()))
+                .setTexture(t.levels[i - 1]->texture);
+            fullScreenTriangle->draw(*upsampleShader);
+        }
+
+    } else {
+        /* Blur first texture horizontally to second one */
+        {
+            Rendering::GpuProfiler::Scope scope(profiler, "horizontal blur");
+            t.framebuffer2.bind();
+            t.framebuffer2.clear(FramebufferClear::Depth);
+            blurShaderHorizontal.setTexture(*t.texture1);
+            fullScreenTriangle->draw(blurShaderHorizontal);
+        }
+
+        /* Blur second texture vertically back to the first one */
+        Rendering::GpuProfiler::Scope scope(profiler, "vertical blur");
+        t.framebuffer1.bind();
+        t.framebuffer1.clear(FramebufferClear::Depth);
+        blurShaderVertical.setTexture(*t.texture2);
+        fullScreenTriangle->draw(blurShaderVertical);
     }
 
-    /* Blur first texture horizontally to second one */
-    framebuffer2.bind();
-    framebuffer2.clear(FramebufferClear::Depth);
-    blurShaderHorizontal.setTexture(texture1);
-    fullScreenTriangle->draw(blurShaderHorizontal);
+    /* The first texture now contains the blurred scene, cache it */
+    _blurCached = true;
 
-    /* Blur second texture vertically to screen FB */
-    defaultFramebuffer.bind();
-    defaultFramebuffer.clear(FramebufferClear::Depth);
-    blurShaderVertical.setTexture(texture2);
-    fullScreenTriangle->draw(blurShaderVertical);
+    /* Display it on screen */
+    Rendering::GpuProfiler::Scope scope(profiler, "blurred copy");
+    _framebuffer->bind();
+    _framebuffer->clear(FramebufferClear::Depth);
+    blurredShader.setTexture(*t.texture1);
+    fullScreenTriangle->draw(blurredShader);
 }
 
 }}
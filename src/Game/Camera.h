@@ -1,40 +1,177 @@
 #ifndef PushTheBox_Game_Camera_h
 #define PushTheBox_Game_Camera_h
 
-#include <Magnum/Framebuffer.h>
-#include <Magnum/Renderbuffer.h>
+#include <memory>
 #include <Magnum/Resource.h>
-#include <Magnum/Texture.h>
 #include <Magnum/SceneGraph/Camera3D.h>
 #include <Magnum/SceneGraph/DualQuaternionTransformation.h>
 
 #include "PushTheBox.h"
+#include "Rendering/ResolutionScaler.h"
 #include "Shaders/Blur.h"
+#include "Shaders/DualFilterBlur.h"
+#include "Shaders/FullScreenTexture.h"
+#include "Shaders/Fxaa.h"
 
 namespace PushTheBox { namespace Game {
 
 class Camera: public Object3D, public SceneGraph::Camera3D {
     public:
+        /** @brief Blur algorithm used for the paused scene */
+        enum class BlurMode: UnsignedByte {
+            /** Two separable Gaussian passes, see @ref Shaders::Blur::Quality */
+            Gaussian,
+
+            /**
+             * Two levels of downsample/upsample pyramid, wider blur with less
+             * texture fetches
+             */
+            DualFilter
+        };
+
         Camera(Object3D* parent = nullptr);
 
+        ~Camera();
+
         void setViewport(const Vector2i& size) override;
 
         void draw(SceneGraph::DrawableGroup3D& group) override;
 
-        inline void setBlurred(bool blurred) { _blurred = blurred; }
+        /** @brief Framebuffer the scene is drawn into */
+        inline AbstractFramebuffer& framebuffer() { return *_framebuffer; }
+
+        /**
+         * @brief Set framebuffer to draw the scene into
+         *
+         * The framebuffer is left bound after @ref draw(), so anything drawn
+         * after goes there as well. It's expected to have the same size as
+         * the viewport. Default is @magnumref{DefaultFramebuffer}.
+         */
+        inline void setFramebuffer(AbstractFramebuffer& framebuffer) { _framebuffer = &framebuffer; }
+
+        /**
+         * @brief Set whether the scene is drawn blurred
+         *
+         * The blurred scene is rendered only once and then cached until the
+         * camera is unblurred or the viewport changes. Offscreen targets for
+         * the blur are taken from @ref Rendering::RenderTargetPool when
+         * needed and given back when the camera is unblurred.
+         */
+        void setBlurred(bool blurred);
+
+        /** @brief Blur mode */
+        inline BlurMode blurMode() const { return _blurMode; }
+
+        /**
+         * @brief Set blur mode
+         *
+         * Default is @ref BlurMode::Gaussian.
+         */
+        void setBlurMode(BlurMode mode);
+
+        /** @brief Whether FXAA is enabled */
+        inline bool isFxaaEnabled() const { return !!fxaaShader; }
+
+        /**
+         * @brief Enable or disable FXAA
+         *
+         * If enabled, the unblurred scene is rendered into an offscreen
+         * texture and filtered with @ref Shaders::Fxaa on the way to the
+         * default framebuffer. Meant to be used in place of a multisampled
+         * default framebuffer. Disabled by default.
+         */
+        void setFxaa(bool enabled);
+
+        /**
+         * @brief Set sample count for the blurred scene
+         *
+         * The blurred scene is rendered multisampled, if supported. Zero
+         * disables multisampling, default is `16`.
+         */
+        void setBlurSampleCount(Int count);
+
+        /** @brief Whether dynamic resolution is enabled */
+        inline bool isDynamicResolutionEnabled() const { return _dynamicResolution; }
+
+        /**
+         * @brief Enable or disable dynamic resolution
+         *
+         * If enabled, the unblurred scene is rendered into an offscreen
+         * texture with size given by @ref resolutionScaler() and then
+         * upscaled to the default framebuffer. Anything drawn after the
+         * camera, such as the HUD, stays at native resolution. Disabled by
+         * default.
+         */
+        void setDynamicResolution(bool enabled);
+
+        /** @brief Dynamic resolution controller */
+        inline Rendering::ResolutionScaler& resolutionScaler() { return _resolutionScaler; }
+
+        /**
+         * @brief Report duration of last frame
+         * @param duration  CPU time spent drawing the frame, excluding the
+         *      buffer swap
+         *
+         * Adapts the resolution scale if dynamic resolution is enabled.
+         * If timer queries are supported, the GPU time of the scene pass
+         * is measured as well and the longer of the two is used, see
+         * @ref Rendering::ResolutionScaler::addFrame().
+         */
+        void addFrameDuration(Float duration);
+
+        /**
+         * @brief Frustum test
+         * @param transformationMatrix  Object transformation relative to
+         *      the camera
+         * @param bounds                Object bounding box
+         * @return `True` if the box is at least partially in the view
+         *      frustum, `false` otherwise
+         *
+         * Meant to be called from drawables, counts the objects for
+         * @ref drawnCount() and @ref culledCount().
+         */
+        bool isVisible(const Matrix4& transformationMatrix, const Range3D& bounds);
+
+        /**
+         * @brief Level of detail for given distance from the camera
+         *
+         * Zero is full detail. The caller is responsible for clamping the
+         * value to count of levels it has available.
+         */
+        static UnsignedInt levelOfDetail(Float distance);
+
+        /** @brief Count of objects drawn in last frame */
+        inline UnsignedInt drawnCount() const { return _drawnCount; }
+
+        /** @brief Count of objects culled in last frame */
+        inline UnsignedInt culledCount() const { return _culledCount; }
 
     private:
-        bool _multisample, _blurred;
+        struct BlurTargets;
+        struct SceneTargets;
+        struct SceneTimer;
 
-        Renderbuffer multisampleColor, multsampleDepth;
-        Framebuffer multisampleFramebuffer;
+        void acquireBlurTargets();
+        void releaseBlurTargets();
+        void acquireSceneTargets();
+        void releaseSceneTargets();
 
-        Texture2D texture1, texture2;
-        Renderbuffer depth;
-        Framebuffer framebuffer1, framebuffer2;
+        bool _multisample, _blurred, _blurCached, _dynamicResolution;
+        Int blurSampleCount;
+        BlurMode _blurMode;
+        UnsignedInt _drawnCount, _culledCount;
+        RenderbufferFormat depthFormat;
+        AbstractFramebuffer* _framebuffer;
 
+        std::unique_ptr<BlurTargets> blurTargets;
+        std::unique_ptr<SceneTargets> sceneTargets;
+        std::unique_ptr<SceneTimer> sceneTimer;
+        Rendering::ResolutionScaler _resolutionScaler;
         Shaders::Blur blurShaderHorizontal;
         Shaders::Blur blurShaderVertical;
+        Shaders::FullScreenTexture blurredShader;
+        std::unique_ptr<Shaders::DualFilterBlur> downsampleShader, upsampleShader;
+        std::unique_ptr<Shaders::Fxaa> fxaaShader;
         Resource<Mesh> fullScreenTriangle;
         Resource<Buffer> fullScreenTriangleBuffer;
 };
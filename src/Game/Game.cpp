@@ -1,21 +1,30 @@
 #include "Game.h"
 
-#include <Magnum/DefaultFramebuffer.h>
+#include <chrono>
+#include <Magnum/AbstractFramebuffer.h>
 #include <Magnum/Renderer.h>
-#include <Magnum/SceneGraph/Animable.h>
-#include <Magnum/SceneGraph/AnimableGroup.h>
 #include <Magnum/SceneGraph/Camera2D.h>
-#include <Magnum/Shaders/Phong.h>
 
 #include "Application.h"
 #include "Game/Camera.h"
+#include "Game/InstanceBatch.h"
 #include "Game/Level.h"
 #include "Game/Player.h"
+#include "Game/Simulation.h"
 #include "Hud.h"
 #include "Menu/Menu.h"
+#include "Rendering/CpuProfiler.h"
+#include "Rendering/TextBatch.h"
+#include "Shaders/CachedPhong.h"
+#include "Shaders/FrameUniforms.h"
 
 namespace PushTheBox { namespace Game {
 
+namespace {
+    const Color3 ambientColor = Color3::fromHsv(Deg(15.0f), 0.5f, 0.06f);
+    const Color3 specularColor = Color3::fromHsv(Deg(50.0f), 0.5f, 1.0f);
+}
+
 Game* Game::_instance = nullptr;
 
 Game* Game::instance() {
@@ -23,7 +32,7 @@ Game* Game::instance() {
     return _instance;
 }
 
-Game::Game(): level(nullptr), paused(true) {
+Game::Game(): level(nullptr), levelId(0), instanced(InstanceBatch::isSupported()), inputSequence(0), inputPending(false), paused(true), animating(false) {
     CORRADE_INTERNAL_ASSERT(!_instance);
     _instance = this;
 
@@ -31,21 +40,35 @@ Game::Game(): level(nullptr), paused(true) {
     setPropagatedEvents(PropagatedEvent::Draw);
 
     /* Add shader to resource manager */
-    SceneResourceManager::instance().set<AbstractShaderProgram>("phong", new Magnum::Shaders::Phong);
-    shader = SceneResourceManager::instance().get<AbstractShaderProgram, Magnum::Shaders::Phong>("phong");
+    SceneResourceManager::instance().set<AbstractShaderProgram>("phong", new Shaders::CachedPhong);
+    shader = SceneResourceManager::instance().get<AbstractShaderProgram, Shaders::CachedPhong>("phong");
+    if(instanced) {
+        SceneResourceManager::instance().set<AbstractShaderProgram>("instanced-phong", new Shaders::InstancedPhong);
+        instancedShader = SceneResourceManager::instance().get<AbstractShaderProgram, Shaders::InstancedPhong>("instanced-phong");
+    } else Debug() << "Instanced rendering is not supported, drawing each object separately";
+    if(Shaders::FrameUniforms::isSupported())
+        frameUniforms.reset(new Shaders::FrameUniforms);
 
     /* Add player */
     player = new Player(&scene, &drawables);
 
     /* Add camera */
-    (camera = new Camera(player))
+    (_camera = new Camera(player))
         ->translate({0.0f, 1.0f, 7.5f})
         .rotateX(Deg(-25.0f));
 
+    /* Game logic, starting with the same camera */
+    simulation.reset(new Simulation(_camera->transformation()));
+
     /* Hud */
-    levelTitle = new LevelTitle(&hudScene, &hudDrawables);
-    remainingTargets = new RemainingTargets(&hudScene, &hudDrawables, &hudAnimables);
-    moves = new Moves(&hudScene, &hudDrawables);
+    hudText.reset(new Rendering::TextBatch);
+    levelTitle = new LevelTitle(&hudScene, &hudDrawables, *hudText);
+    remainingTargets = new RemainingTargets(&hudScene, &hudDrawables, *hudText);
+    moves = new Moves(&hudScene, &hudDrawables, *hudText);
+    gpuTimes = new GpuTimes(&hudScene, &hudDrawables, *hudText);
+    Interconnect::connect(Application::instance()->gpuProfiler(), &Rendering::GpuProfiler::updated, *gpuTimes, &GpuTimes::update);
+    inputLatency = new InputLatencyLine(&hudScene, &hudDrawables, *hudText);
+    Interconnect::connect(Application::instance()->inputLatency(), &Rendering::InputLatency::updated, *inputLatency, &InputLatencyLine::update);
 
     /* Hud camera */
     (hudCamera = new SceneGraph::Camera2D(hudScene))
@@ -66,17 +89,19 @@ Game::~Game() {
 
 void Game::loadLevel(const std::string& name) {
     delete level;
-    level = new Level(name, &scene, &drawables, &animables);
+    level = new Level(name, &scene, &drawables);
+
+    /* Place the player the same way as the simulation does, so nothing
+       jumps before the first snapshot of this level arrives */
+    const Deg rotation = Math::lerp(Deg(-30.0f), Deg(30.0f), Float(std::rand())/Float(RAND_MAX));
     player->resetTransformation()
-          .rotateY(Math::lerp(Deg(-30.0f), Deg(30.0f), Float(std::rand())/Float(RAND_MAX)))
-          .translate(Math::swizzle<'x', '0', 'y'>(Vector2(level->playerPosition())));
+          .rotateY(rotation)
+          .translate(Math::swizzle<'x', '0', 'y'>(Vector2(level->state().playerPosition)));
+    simulation->load(++levelId, level->state(), rotation);
 
-    /* Connect HUD to level state changes */
     levelTitle->update(level->title());
-    remainingTargets->update(level->remainingTargets());
-    moves->update(level->moves());
-    Interconnect::connect(*level, &Level::remainingTargetsChanged, *remainingTargets, &RemainingTargets::update);
-    Interconnect::connect(*level, &Level::movesChanged, *moves, &Moves::update);
+    remainingTargets->update(level->state().remainingTargets);
+    moves->update(0);
 }
 
 void Game::restartLevel() {
@@ -90,17 +115,26 @@ void Game::restartLevel() {
 
 void Game::nextLevel() {
     CORRADE_ASSERT(level, "Game::Game::nextLevel(): no level loaded", );
-    CORRADE_ASSERT(!level->remainingTargets(), "Game::Game::nextLevel(): level not solved", );
 
     /* copy string to avoid dangling reference */
     loadLevel(std::string(level->nextName()));
+    redraw();
 }
 
 void Game::movePlayer(const Vector2i& direction) {
     CORRADE_ASSERT(level, "Game::Game::movePlayer(): no level loaded", );
 
-    if(level->movePlayer(direction))
-        player->translate(Math::swizzle<'x', '0', 'y'>(Vector2(direction)));
+    simulation->movePlayer(direction);
+}
+
+void Game::setPlayerRotation(Deg angle) {
+    CORRADE_ASSERT(level, "Game::Game::setPlayerRotation(): no level loaded", );
+
+    simulation->setPlayerRotation(angle);
+}
+
+void Game::synchronize() {
+    simulation->synchronize();
 }
 
 void Game::pause() {
@@ -115,77 +149,163 @@ void Game::focusEvent() {
     Application::instance()->setMouseLocked(true);
 
     paused = false;
-    camera->setBlurred(false);
+    _camera->setBlurred(false);
     setPropagatedEvents(PropagatedEvent::Draw|PropagatedEvent::Input);
+    redraw();
 }
 
 void Game::blurEvent() {
     /* Draw the game in the background */
     setPropagatedEvents(PropagatedEvent::Draw);
-    camera->setBlurred(true);
+    _camera->setBlurred(true);
     paused = true;
 
     Application::instance()->setMouseLocked(false);
+    redraw();
 }
 
 void Game::viewportEvent(const Vector2i& size) {
-    camera->setViewport(size);
+    _camera->setViewport(size);
     hudCamera->setViewport(size);
 }
 
 void Game::drawEvent() {
-    defaultFramebuffer.clear(FramebufferClear::Color|FramebufferClear::Depth);
+    PUSHTHEBOX_PROFILE_SCOPE("Game::drawEvent");
+    const std::chrono::steady_clock::time_point frameStart = std::chrono::steady_clock::now();
+    _camera->framebuffer().clear(FramebufferClear::Color|FramebufferClear::Depth);
+
+    /* If nothing was drawn for a while, the last frame time is stale and
+       animations started now would skip right to their end */
+    Timeline& timeline = Application::instance()->timeline();
+    if(!animating) timeline.nextFrame();
+
+    /* Take the newest simulation state */
+    simulation->update();
+    simulation->fetch();
+    const Simulation::Snapshot& snapshot = simulation->snapshot();
+    if(inputPending && snapshot.sequence >= inputSequence) {
+        Application::instance()->inputLatency().input(inputTime);
+        inputPending = false;
+    }
 
-    /* Animate */
-    animables.step(Application::instance()->timeline().previousFrameTime(),
-                   Application::instance()->timeline().previousFrameDuration());
-    hudAnimables.step(Application::instance()->timeline().previousFrameTime(),
-                      Application::instance()->timeline().previousFrameDuration());
+    /* Snapshots of previous level don't match the current one, keep the
+       initial state until the first snapshot of this level arrives */
+    bool current = snapshot.level == levelId;
+    if(current && !snapshot.remainingTargets) {
+        nextLevel();
+        current = false;
+    }
+    if(current) {
+        player->setTransformation(snapshot.player);
+        _camera->setTransformation(snapshot.camera);
+        for(std::size_t i = 0; i != snapshot.boxes.size(); ++i)
+            level->setBox(i, snapshot.boxes[i].position, snapshot.boxes[i].color);
+        remainingTargets->update(snapshot.remainingTargets);
+        remainingTargets->setScale(snapshot.remainingTargetsScale);
+        moves->update(snapshot.moves);
+    }
 
     /* Light is above the center of level */
     Vector3 lightPosition = Vector3(1.0f, 4.0f, 1.2f) +
             Math::swizzle<'x', '0', 'y'>(Vector2(level->size()/2));
 
-    /* Shader settings commn for all objects */
-    shader->setLightPosition(camera->cameraMatrix().transformPoint(lightPosition))
-          .setProjectionMatrix(camera->projectionMatrix())
-          .setAmbientColor(Color3::fromHsv(Deg(15.0f), 0.5f, 0.06f))
-          .setSpecularColor(Color3::fromHsv(Deg(50.0f), 0.5f, 1.0f));
-    camera->draw(drawables);
+    /* Shader settings common for all objects, in a single buffer shared by
+       all shaders if possible, otherwise set to each shader separately and
+       uploaded only if they changed */
+    const Vector3 transformedLightPosition = _camera->cameraMatrix().transformPoint(lightPosition);
+    if(frameUniforms)
+        frameUniforms->set(_camera->projectionMatrix(), transformedLightPosition, ambientColor, specularColor);
+    else {
+        const UnsignedInt uploadCount = shader->uploadCount();
+        shader->setLightPosition(transformedLightPosition)
+              .setProjectionMatrix(_camera->projectionMatrix())
+              .setAmbientColor(ambientColor)
+              .setSpecularColor(specularColor);
+        Application::instance()->renderQueue().addUniformUploads(shader->uploadCount() - uploadCount);
+        if(instanced) instancedShader->setLightPosition(transformedLightPosition)
+              .setProjectionMatrix(_camera->projectionMatrix())
+              .setAmbientColor(ambientColor)
+              .setSpecularColor(specularColor);
+    }
+    _camera->draw(drawables);
 
     /* Draw HUD */
     if(!paused) {
+        Rendering::GpuProfiler::Scope scope(Application::instance()->gpuProfiler(), "hud");
         Renderer::enable(Renderer::Feature::Blending);
         Renderer::setBlendFunction(Renderer::BlendFunction::One, Renderer::BlendFunction::OneMinusSourceAlpha);
         Renderer::disable(Renderer::Feature::DepthTest);
         hudCamera->draw(hudDrawables);
+        hudText->draw(hudCamera->projectionMatrix());
+        Application::instance()->renderQueue().flush();
         Renderer::enable(Renderer::Feature::DepthTest);
         Renderer::disable(Renderer::Feature::Blending);
     }
 
-    /** @todo properly schedule redraw only if there is something to animate */
-    redraw();
+    /* Time spent working on the frame, unlike time between buffer swaps it
+       isn't rounded up to the refresh interval by vertical sync */
+    _camera->addFrameDuration(std::chrono::duration<Float>(std::chrono::steady_clock::now() - frameStart).count());
+
+    /* Draw next frame only if there is something to animate or the
+       simulation didn't process all input yet, otherwise wait for input */
+    animating = !current || snapshot.animating ||
+        snapshot.sequence < simulation->submittedSequence() ||
+        Application::instance()->gpuProfiler().isEnabled();
+    if(animating) redraw();
 }
 
 void Game::keyPressEvent(KeyEvent& event) {
-    /* Move forward */
-    if(event.key() == KeyEvent::Key::Up || event.key() == KeyEvent::Key::W) {
-        Vector3 direction = player->transformation().rotation().transformVectorNormalized(Vector3::zAxis());
-        Deg angle = Math::angle(Vector3::zAxis(), direction);
+    const std::chrono::steady_clock::time_point time = std::chrono::steady_clock::now();
 
-        if(angle < Deg(30.0f))
-            movePlayer({0, -1});
-        else if(angle > Deg(60.0f) && angle < Deg(120.0f))
-            movePlayer({direction.x() > 0 ? -1 : 1, 0});
-        else if(angle > Deg(150.0f))
-            movePlayer({0, 1});
-
-        if(!level->remainingTargets()) nextLevel();
+    /* Move forward, the next level is loaded when the simulation reports
+       the level as solved */
+    if(event.key() == KeyEvent::Key::Up || event.key() == KeyEvent::Key::W) {
+        simulation->walkForward();
+        inputAccepted(time);
 
     /* Restart level */
     } else if(event.key() == KeyEvent::Key::R) {
         restartLevel();
 
+    /* Print rendering statistics */
+    } else if(event.key() == KeyEvent::Key::F3) {
+        const Rendering::RenderQueue::Statistics& statistics = Application::instance()->renderQueue().statistics();
+        Debug() << "Drawn" << _camera->drawnCount() << "and culled" << _camera->culledCount() << "level objects";
+        Debug() << statistics.draws << "draws," << statistics.shaderBinds << "shader binds," << statistics.meshBinds << "mesh binds," << statistics.uniformUploads << "uniform uploads," << statistics.unshadedDraws << "unshaded draws in last frame";
+        Debug() << Application::instance()->renderTargetPool().targetCount() << "pooled render targets with" << Application::instance()->renderTargetPool().pixelCount() << "pixels";
+        Debug() << "Last frame took" << Application::instance()->timeline().previousFrameDuration()*1000.0f << "ms";
+        if(_camera->isDynamicResolutionEnabled())
+            Debug() << "Resolution scale" << _camera->resolutionScaler().scale();
+
+    /* Overdraw debugging */
+    } else if(event.key() == KeyEvent::Key::F4) {
+        Rendering::RenderQueue& queue = Application::instance()->renderQueue();
+        queue.setOverdrawVisualization(!queue.isOverdrawVisualizationEnabled());
+        Debug() << "Overdraw visualization" << (queue.isOverdrawVisualizationEnabled() ? "enabled" : "disabled");
+    } else if(event.key() == KeyEvent::Key::F5) {
+        Rendering::RenderQueue& queue = Application::instance()->renderQueue();
+        queue.setDepthPrepass(!queue.isDepthPrepassEnabled());
+        Debug() << "Depth pre-pass" << (queue.isDepthPrepassEnabled() ? "enabled" : "disabled");
+    } else if(event.key() == KeyEvent::Key::F6) {
+        Rendering::RenderQueue& queue = Application::instance()->renderQueue();
+        queue.setSortOrder(queue.sortOrder() == Rendering::RenderQueue::SortOrder::State ?
+            Rendering::RenderQueue::SortOrder::FrontToBack : Rendering::RenderQueue::SortOrder::State);
+        Debug() << "Sorting" << (queue.sortOrder() == Rendering::RenderQueue::SortOrder::State ? "by state" : "front to back");
+
+    /* GPU profiler overlay and log */
+    } else if(event.key() == KeyEvent::Key::F7) {
+        Rendering::GpuProfiler& profiler = Application::instance()->gpuProfiler();
+        profiler.setEnabled(!profiler.isEnabled());
+        if(!profiler.isEnabled()) gpuTimes->clear();
+        if(!Rendering::GpuProfiler::isSupported())
+            Debug() << "Timer queries are not supported, GPU profiler is not available";
+    } else if(event.key() == KeyEvent::Key::F8) {
+        Application::instance()->gpuProfiler().print();
+
+    /* Input latency overlay */
+    } else if(event.key() == KeyEvent::Key::F9) {
+        inputLatency->setShown(!inputLatency->isShown());
+
     /* Switch to menu */
     } else if(event.key() == KeyEvent::Key::Esc)
         pause();
@@ -206,18 +326,24 @@ void Game::mousePressEvent(MouseEvent& event) {
 }
 
 void Game::mouseMoveEvent(MouseMoveEvent& event) {
-    /** @todo mouse sensitivity */
-    player->normalizeRotation().rotateYLocal(-Rad(Constants::pi())*event.relativePosition().x()/500.0f);
+    const std::chrono::steady_clock::time_point time = std::chrono::steady_clock::now();
 
-    Rad angle(-Constants::pi()*event.relativePosition().y()/500.0f);
-    DualQuaternion xRotation = DualQuaternion::rotation(angle, Vector3::xAxis())*camera->transformation();
-
-    /* Don't rotate under the floor */
-    if(Math::abs(Math::dot(xRotation.real().transformVector(Vector3::yAxis()), Vector3(0.0f, 1.0f, -1.0f).normalized())) > 0.75f)
-        camera->setTransformation(xRotation.normalized());
+    simulation->look(event.relativePosition());
 
     event.setAccepted();
+    inputAccepted(time);
     redraw();
 }
 
+void Game::inputAccepted(const std::chrono::steady_clock::time_point time) {
+    /* Measured from the earliest input to the frame showing its effect,
+       which is the first one drawing a snapshot with its command applied.
+       Only for input submitting a simulation command, other keys have no
+       snapshot to wait for. */
+    if(inputPending) return;
+    inputPending = true;
+    inputTime = time;
+    inputSequence = simulation->submittedSequence();
+}
+
 }}
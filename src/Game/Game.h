@@ -5,12 +5,13 @@
  * @brief Class PushTheBox::Game::Game
  */
 
+#include <chrono>
+#include <memory>
 #include <Corrade/Interconnect/Receiver.h>
 #include <Magnum/ResourceManager.h>
 #include <Magnum/Timeline.h>
 #include <Magnum/Platform/Screen.h>
 #include <Magnum/Platform/Sdl2Application.h>
-#include <Magnum/SceneGraph/AnimableGroup.h>
 #include <Magnum/SceneGraph/Drawable.h>
 #include <Magnum/SceneGraph/TranslationTransformation.h>
 #include <Magnum/SceneGraph/DualQuaternionTransformation.h>
@@ -19,19 +20,35 @@
 
 #include "PushTheBox.h"
 
-namespace PushTheBox { namespace Game {
+namespace PushTheBox {
+
+namespace Rendering {
+    class TextBatch;
+}
+
+namespace Shaders {
+    class CachedPhong;
+    class FrameUniforms;
+    class InstancedPhong;
+}
+
+namespace Game {
 
 class Camera;
+class GpuTimes;
+class InputLatencyLine;
 class Level;
 class LevelTitle;
 class Moves;
 class Player;
 class RemainingTargets;
+class Simulation;
 
 /**
 @brief %Game screen
 
-Renders current state of the game.
+Renders current state of the game. Input is passed to the @ref Simulation
+and each frame draws its newest snapshot.
 */
 class Game: public Platform::Screen, public Interconnect::Receiver {
     public:
@@ -46,9 +63,31 @@ class Game: public Platform::Screen, public Interconnect::Receiver {
         void loadLevel(const std::string& name);
         void movePlayer(const Vector2i& direction);
 
+        /** @brief Rotate the player in place, for scripted views */
+        void setPlayerRotation(Deg angle);
+
+        /**
+         * @brief Wait for the simulation
+         *
+         * Ensures that the next frame shows the effect of all previous
+         * calls, for scripted views.
+         */
+        void synchronize();
+
         void pause();
         void resume();
 
+        /** @brief Game camera */
+        inline Camera& camera() { return *_camera; }
+
+        /**
+         * @brief Whether the last frame had running animations
+         *
+         * Also `true` while the simulation didn't catch up with the input
+         * yet.
+         */
+        inline bool isAnimating() const { return animating; }
+
     protected:
         void focusEvent() override;
         void blurEvent() override;
@@ -59,26 +98,39 @@ class Game: public Platform::Screen, public Interconnect::Receiver {
         void mouseMoveEvent(MouseMoveEvent& event) override;
 
     private:
+        void inputAccepted(std::chrono::steady_clock::time_point time);
+
         static Game* _instance;
 
         Scene3D scene;
         SceneGraph::DrawableGroup3D drawables;
-        SceneGraph::AnimableGroup3D animables;
 
-        Resource<AbstractShaderProgram, Shaders::Phong> shader;
-        Camera* camera;
+        Resource<AbstractShaderProgram, Shaders::CachedPhong> shader;
+        Resource<AbstractShaderProgram, Shaders::InstancedPhong> instancedShader;
+        std::unique_ptr<Shaders::FrameUniforms> frameUniforms;
+        Camera* _camera;
         Level* level;
+        UnsignedInt levelId;
         Player* player;
+        bool instanced;
+        std::unique_ptr<Simulation> simulation;
+
+        /* Earliest input not shown yet, for latency measurement */
+        std::chrono::steady_clock::time_point inputTime;
+        UnsignedLong inputSequence;
+        bool inputPending;
 
+        std::unique_ptr<Rendering::TextBatch> hudText;
         Scene2D hudScene;
         SceneGraph::DrawableGroup2D hudDrawables;
-        SceneGraph::AnimableGroup2D hudAnimables;
         SceneGraph::Camera2D* hudCamera;
-        bool paused;
+        bool paused, animating;
 
         LevelTitle* levelTitle;
         RemainingTargets* remainingTargets;
         Moves* moves;
+        GpuTimes* gpuTimes;
+        InputLatencyLine* inputLatency;
 };
 
 }}
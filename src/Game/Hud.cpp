@@ -1,90 +1,182 @@
 #include "Game/Hud.h"
 
+#include <Corrade/Utility/Assert.h>
 #include <Magnum/SceneGraph/AbstractCamera.h>
 #include <Magnum/Text/AbstractFont.h>
-#include <Magnum/Text/GlyphCache.h>
-#include <Magnum/Text/Renderer.h>
+#include <Magnum/Text/Alignment.h>
 
-#if defined(CORRADE_TARGET_NACL_NEWLIB) || defined(__MINGW32__)
+#include <iomanip>
 #include <sstream>
-#endif
+
+#include "Application.h"
+#include "Rendering/TextBatch.h"
 
 namespace PushTheBox { namespace Game {
 
-AbstractHudText::AbstractHudText(Object2D* parent, SceneGraph::DrawableGroup2D* drawables): Object2D(parent), SceneGraph::Drawable2D(*this, drawables), text(nullptr), font(SceneResourceManager::instance().get<Text::AbstractFont>("font")), glyphCache(SceneResourceManager::instance().get<Text::GlyphCache>("cache")), shader(SceneResourceManager::instance().get<AbstractShaderProgram, Shaders::DistanceFieldVector2D>("text2d")) {}
+AbstractHudText::AbstractHudText(Object2D* parent, SceneGraph::DrawableGroup2D* drawables, Rendering::TextBatch& batch, const UnsignedInt glyphCapacity): Object2D(parent), SceneGraph::Drawable2D(*this, drawables), batch(batch), id(batch.add(glyphCapacity)) {}
 
 AbstractHudText::~AbstractHudText() = default;
 
-void AbstractHudText::draw(const Matrix3& transformationMatrix, SceneGraph::Camera2D& camera) {
-    shader->setTransformationProjectionMatrix(camera.projectionMatrix()*transformationMatrix)
-        .setColor(Color3(1.0f))
-        .setOutlineRange(0.5f, 1.0f)
-        .setVectorTexture(glyphCache->texture());
-
-    text->mesh().draw(*shader);
+void AbstractHudText::draw(const Matrix3& transformationMatrix, SceneGraph::Camera2D&) {
+    /* The 2D scene graph can only translate, the scale is only added by
+       RemainingTargets and is uniform */
+    batch.setTransformation(id, transformationMatrix.translation(), transformationMatrix.right().x());
 }
 
-LevelTitle::LevelTitle(Object2D* parent, SceneGraph::DrawableGroup2D* drawables): AbstractHudText(parent, drawables) {
-    (text = new Text::Renderer2D(*font, *glyphCache, 0.06f, Text::Alignment::TopLeft))
-        ->reserve(32, BufferUsage::StaticDraw, BufferUsage::StaticDraw);
-
+LevelTitle::LevelTitle(Object2D* parent, SceneGraph::DrawableGroup2D* drawables, Rendering::TextBatch& batch): AbstractHudText(parent, drawables, batch, 32) {
     translate({-1.303f, 0.97f});
 }
 
 void LevelTitle::update(const std::string& name) {
-    text->render(name);
+    batch.setText(id, name, 0.06f, Text::Alignment::TopLeft);
 }
 
-RemainingTargets::RemainingTargets(Object2D* parent, SceneGraph::DrawableGroup2D* drawables, SceneGraph::AnimableGroup2D* animables): AbstractHudText(parent, drawables), SceneGraph::Animable2D(*this, animables) {
-    (text = new Text::Renderer2D(*font, *glyphCache, 0.06f, Text::Alignment::LineLeft))
-        ->reserve(32, BufferUsage::DynamicDraw, BufferUsage::StaticDraw);
+HudCounter::HudCounter(Object2D* parent, SceneGraph::DrawableGroup2D* drawables, Rendering::TextBatch& batch, const Float size, const Text::Alignment alignment, const UnsignedInt digitCount, const std::string& label): AbstractHudText(parent, drawables, batch, digitCount + label.size()), digitCount(digitCount), value(~UnsignedInt{}), slotAdvance(0.0f) {
+    CORRADE_INTERNAL_ASSERT(digitCount);
+
+    Text::AbstractFont& font = batch.font();
+    Text::GlyphCache& glyphCache = batch.glyphCache();
+
+    /* Glyph quads of all digits, relative to their own cursor position. The
+       slots are as wide as the widest digit and the digits are centered in
+       them, so the label doesn't need to move when the value changes. */
+    Vector2 cursor;
+    Range2D rectangle;
+    std::unique_ptr<Text::AbstractLayouter> digitLayouter = font.layout(glyphCache, size, "0123456789");
+    Float digitAdvances[10];
+    for(UnsignedInt i = 0; i != 10; ++i) {
+        const Vector2 previousCursor = cursor;
+        std::tie(digitPositions[i], digitTextureCoordinates[i]) = digitLayouter->renderGlyph(i, cursor, rectangle);
+        digitPositions[i] = digitPositions[i].translated(-previousCursor);
+        digitAdvances[i] = cursor.x() - previousCursor.x();
+        slotAdvance = Math::max(slotAdvance, digitAdvances[i]);
+    }
+    for(UnsignedInt i = 0; i != 10; ++i)
+        digitPositions[i] = digitPositions[i].translated({(slotAdvance - digitAdvances[i])*0.5f, 0.0f});
+
+    /* Label quads go after the digit slots */
+    std::unique_ptr<Text::AbstractLayouter> labelLayouter = font.layout(glyphCache, size, label);
+    std::vector<std::pair<Range2D, Range2D>> labelGlyphs;
+    labelGlyphs.reserve(labelLayouter->glyphCount());
+    cursor = Vector2::xAxis(slotAdvance*digitCount);
+    rectangle = {};
+    for(UnsignedInt i = 0; i != labelLayouter->glyphCount(); ++i)
+        labelGlyphs.push_back(labelLayouter->renderGlyph(i, cursor, rectangle));
+
+    /* Bounds of the label and fully occupied digit slots */
+    Range2D bounds = rectangle;
+    for(UnsignedInt i = 0; i != 10; ++i) {
+        bounds.bottomLeft() = Math::min(bounds.bottomLeft(), digitPositions[i].bottomLeft());
+        bounds.topRight() = Math::max(bounds.topRight(), digitPositions[i].topRight() + Vector2::xAxis(slotAdvance*(digitCount - 1)));
+    }
+
+    /* Align the whole counter, digit slots stay empty until a value is set */
+    if(alignment == Text::Alignment::LineLeft)
+        slotOrigin = Vector2::xAxis(-bounds.left());
+    else if(alignment == Text::Alignment::TopRight)
+        slotOrigin = -bounds.topRight();
+    else CORRADE_ASSERT_UNREACHABLE();
+    for(std::size_t i = 0; i != labelGlyphs.size(); ++i)
+        batch.setGlyph(id, digitCount + i, labelGlyphs[i].first.translated(slotOrigin), labelGlyphs[i].second);
+}
 
-    setDuration(0.4f);
-    setRepeated(true);
-    setRepeatCount(2);
+void HudCounter::setValue(UnsignedInt value) {
+    UnsignedInt maxValue = 9;
+    for(UnsignedInt i = 1; i != digitCount; ++i) maxValue = maxValue*10 + 9;
+    value = Math::min(value, maxValue);
+    if(value == this->value) return;
+    this->value = value;
+
+    /* Digits are right-aligned in the slots, the leading slots are hidden */
+    UnsignedInt slot = digitCount;
+    do {
+        const UnsignedInt digit = value%10;
+        --slot;
+        batch.setGlyph(id, slot, digitPositions[digit].translated(slotOrigin + Vector2::xAxis(slotAdvance*slot)), digitTextureCoordinates[digit]);
+    } while(value /= 10);
+    while(slot) batch.setGlyph(id, --slot, {}, {});
+}
 
+RemainingTargets::RemainingTargets(Object2D* parent, SceneGraph::DrawableGroup2D* drawables, Rendering::TextBatch& batch): HudCounter(parent, drawables, batch, 0.06f, Text::Alignment::LineLeft, 2, " remaining targets"), scale(1.0f) {
     translate({-1.303f, -0.97f});
 }
 
 void RemainingTargets::update(UnsignedInt count) {
-    #if !defined(CORRADE_TARGET_NACL_NEWLIB) && !defined(__MINGW32__)
-    text->render(std::to_string(count) + " remaining targets");
-    #else
-    std::ostringstream out;
-    out << count << " remaining targets";
-    text->render(out.str());
-    #endif
+    setValue(count);
+}
 
-    setState(SceneGraph::AnimationState::Running);
+void RemainingTargets::setScale(Float scale) {
+    this->scale = scale;
 }
 
 void RemainingTargets::draw(const Matrix3& transformationMatrix, SceneGraph::Camera2D& camera) {
     AbstractHudText::draw(transformationMatrix*Matrix3::scaling(Vector2(scale)), camera);
 }
 
-void RemainingTargets::animationStep(Float time, Float) {
-    scale = 1.0f + Math::sin(Rad(Constants::pi()*time/duration()))*0.35f;
+Moves::Moves(Object2D* parent, SceneGraph::DrawableGroup2D* drawables, Rendering::TextBatch& batch): HudCounter(parent, drawables, batch, 0.06f, Text::Alignment::TopRight, 5, " moves") {
+    translate({1.303f, 0.97f});
 }
 
-void RemainingTargets::animationStopped() {
-    scale = 1.0f;
+void Moves::update(UnsignedInt count) {
+    setValue(count);
 }
 
-Moves::Moves(Object2D* parent, SceneGraph::DrawableGroup2D* drawables): AbstractHudText(parent, drawables) {
-    (text = new Text::Renderer2D(*font, *glyphCache, 0.06f, Text::Alignment::TopRight))
-        ->reserve(32, BufferUsage::DynamicDraw, BufferUsage::StaticDraw);
+ProfilerLine::ProfilerLine(Object2D* parent, SceneGraph::DrawableGroup2D* drawables, Rendering::TextBatch& batch, const UnsignedInt glyphCapacity): AbstractHudText(parent, drawables, batch, glyphCapacity) {}
 
-    translate({1.303f, 0.97f});
+void ProfilerLine::update(const std::string& line) {
+    batch.setText(id, line, 0.04f, Text::Alignment::TopRight);
 }
 
-void Moves::update(UnsignedInt count) {
-    #if !defined(CORRADE_TARGET_NACL_NEWLIB) && !defined(__MINGW32__)
-    text->render(std::to_string(count) + " moves");
-    #else
+InputLatencyLine::InputLatencyLine(Object2D* parent, SceneGraph::DrawableGroup2D* drawables, Rendering::TextBatch& batch): ProfilerLine(parent, drawables, batch, 48), shown(false) {
+    translate({1.303f, -0.93f});
+}
+
+void InputLatencyLine::setShown(bool shown) {
+    this->shown = shown;
+    if(shown) update();
+    else ProfilerLine::update({});
+}
+
+void InputLatencyLine::update() {
+    if(!shown) return;
+
+    const Rendering::InputLatency& latency = Application::instance()->inputLatency();
     std::ostringstream out;
-    out << count << " moves";
-    text->render(out.str());
-    #endif
+    out << std::fixed << std::setprecision(2) << "input p50 " << latency.percentile(50.0) << " p95 " << latency.percentile(95.0) << " p99 " << latency.percentile(99.0) << " ms";
+    ProfilerLine::update(out.str());
+}
+
+GpuTimes::GpuTimes(Object2D* parent, SceneGraph::DrawableGroup2D* drawables, Rendering::TextBatch& batch): Object2D(parent), drawables(drawables), batch(batch) {
+    translate({1.303f, 0.88f});
+}
+
+void GpuTimes::update() {
+    const std::vector<Rendering::GpuProfiler::Pass>& passes = Application::instance()->gpuProfiler().passes();
+
+    /* Add lines for new passes, the last line is total */
+    while(lines.size() < passes.size() + 1) {
+        ProfilerLine* line = new ProfilerLine(this, drawables, batch);
+        line->translate({0.0f, -0.05f*lines.size()});
+        lines.push_back(line);
+    }
+
+    Double total = 0.0;
+    for(std::size_t i = 0; i != passes.size(); ++i) {
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(2) << passes[i].name << " " << passes[i].time << " ms";
+        lines[i]->update(out.str());
+        total += passes[i].time;
+    }
+
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(2) << "GPU total " << total << " ms";
+    lines[passes.size()]->update(out.str());
+    for(std::size_t i = passes.size() + 1; i != lines.size(); ++i)
+        lines[i]->update({});
+}
+
+void GpuTimes::clear() {
+    for(ProfilerLine* line: lines) line->update({});
 }
 
 }}
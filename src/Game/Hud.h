@@ -1,64 +1,121 @@
 #ifndef PushTheBox_Game_Hud_h
 #define PushTheBox_Game_Hud_h
 
+#include <vector>
 #include <Corrade/Interconnect/Receiver.h>
-#include <Magnum/ResourceManager.h>
-#include <Magnum/SceneGraph/Animable.h>
+#include <Magnum/Math/Range.h>
 #include <Magnum/SceneGraph/Drawable.h>
 #include <Magnum/SceneGraph/TranslationTransformation.h>
-#include <Magnum/Shaders/DistanceFieldVector.h>
 #include <Magnum/Text/Text.h>
 
 #include "PushTheBox.h"
 
-namespace PushTheBox { namespace Game {
+namespace PushTheBox {
 
+namespace Rendering {
+    class TextBatch;
+}
+
+namespace Game {
+
+/* Text in the HUD text batch, drawing only updates its transformation there */
 class AbstractHudText: public Object2D, SceneGraph::Drawable2D, public Interconnect::Receiver {
     public:
-        AbstractHudText(Object2D* parent, SceneGraph::DrawableGroup2D* drawables);
+        AbstractHudText(Object2D* parent, SceneGraph::DrawableGroup2D* drawables, Rendering::TextBatch& batch, UnsignedInt glyphCapacity);
 
         ~AbstractHudText();
 
     protected:
         void draw(const Matrix3& transformationMatrix, SceneGraph::Camera2D& camera) override;
 
-        Text::Renderer2D* text;
-        Resource<Text::AbstractFont> font;
-        Resource<Text::GlyphCache> glyphCache;
-
-    private:
-        Resource<AbstractShaderProgram, Magnum::Shaders::DistanceFieldVector2D> shader;
+        Rendering::TextBatch& batch;
+        const UnsignedInt id;
 };
 
 class LevelTitle: public AbstractHudText {
     public:
-        LevelTitle(Object2D* parent, SceneGraph::DrawableGroup2D* drawables);
+        LevelTitle(Object2D* parent, SceneGraph::DrawableGroup2D* drawables, Rendering::TextBatch& batch);
 
         void update(const std::string& name);
 };
 
-class RemainingTargets: public AbstractHudText, SceneGraph::Animable2D {
+/* Number followed by a static label. The label and fixed-width slots for
+   the digits are laid out only once, changing the value just rewrites the
+   digit glyphs in the batch, without any allocation or text shaping. Only
+   LineLeft and TopRight alignment is supported. */
+class HudCounter: public AbstractHudText {
+    public:
+        HudCounter(Object2D* parent, SceneGraph::DrawableGroup2D* drawables, Rendering::TextBatch& batch, Float size, Text::Alignment alignment, UnsignedInt digitCount, const std::string& label);
+
+        /* Values which don't fit into the digit slots are clamped, setting
+           the same value again does nothing */
+        void setValue(UnsignedInt value);
+
+    private:
+        UnsignedInt digitCount, value;
+        Range2D digitPositions[10], digitTextureCoordinates[10];
+        Vector2 slotOrigin;
+        Float slotAdvance;
+};
+
+/* The pulse on change is animated by the simulation, only its scale is set
+   here */
+class RemainingTargets: public HudCounter {
     public:
-        RemainingTargets(Object2D* parent, SceneGraph::DrawableGroup2D* drawables, SceneGraph::AnimableGroup2D* animables);
+        RemainingTargets(Object2D* parent, SceneGraph::DrawableGroup2D* drawables, Rendering::TextBatch& batch);
 
         void update(UnsignedInt count);
+        void setScale(Float scale);
 
     protected:
         void draw(const Matrix3& transformationMatrix, SceneGraph::Camera2D& camera) override;
-        void animationStep(Float time, Float delta) override;
-        void animationStopped() override;
 
     private:
         Float scale;
 };
 
-class Moves: public AbstractHudText {
+class Moves: public HudCounter {
     public:
-        Moves(Object2D* parent, SceneGraph::DrawableGroup2D* drawables);
+        Moves(Object2D* parent, SceneGraph::DrawableGroup2D* drawables, Rendering::TextBatch& batch);
 
         void update(UnsignedInt count);
 };
 
+class ProfilerLine: public AbstractHudText {
+    public:
+        ProfilerLine(Object2D* parent, SceneGraph::DrawableGroup2D* drawables, Rendering::TextBatch& batch, UnsignedInt glyphCapacity = 32);
+
+        void update(const std::string& line);
+};
+
+/* Input latency percentiles, shown on request */
+class InputLatencyLine: public ProfilerLine {
+    public:
+        InputLatencyLine(Object2D* parent, SceneGraph::DrawableGroup2D* drawables, Rendering::TextBatch& batch);
+
+        inline bool isShown() const { return shown; }
+        void setShown(bool shown);
+
+        void update();
+
+    private:
+        bool shown;
+};
+
+/* GPU profiler results, one line per pass */
+class GpuTimes: public Object2D, public Interconnect::Receiver {
+    public:
+        GpuTimes(Object2D* parent, SceneGraph::DrawableGroup2D* drawables, Rendering::TextBatch& batch);
+
+        void update();
+        void clear();
+
+    private:
+        SceneGraph::DrawableGroup2D* drawables;
+        Rendering::TextBatch& batch;
+        std::vector<ProfilerLine*> lines;
+};
+
 }}
 
 #endif
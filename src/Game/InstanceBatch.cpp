@@ -0,0 +1,87 @@
+#include "InstanceBatch.h"
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Magnum/Context.h>
+#include <Magnum/Extensions.h>
+#include <Magnum/Math/Functions.h>
+
+#include "Application.h"
+
+namespace PushTheBox { namespace Game {
+
+bool InstanceBatch::isSupported() {
+    #ifndef MAGNUM_TARGET_GLES
+    return Context::current().isExtensionSupported<Extensions::GL::ARB::instanced_arrays>() &&
+           Context::current().isExtensionSupported<Extensions::GL::ARB::draw_instanced>();
+    #elif defined(MAGNUM_TARGET_GLES2)
+    #ifndef MAGNUM_TARGET_WEBGL
+    return Context::current().isExtensionSupported<Extensions::GL::ANGLE::instanced_arrays>() ||
+           Context::current().isExtensionSupported<Extensions::GL::EXT::instanced_arrays>() ||
+           Context::current().isExtensionSupported<Extensions::GL::NV::instanced_arrays>();
+    #else
+    return Context::current().isExtensionSupported<Extensions::GL::ANGLE::instanced_arrays>();
+    #endif
+    #else
+    return true;
+    #endif
+}
+
+InstanceBatch::InstanceBatch(ResourceKey mesh, Object3D* parent, SceneGraph::DrawableGroup3D* drawables): Object3D(parent), SceneGraph::Drawable3D(*this, drawables), dirtyBegin(0), dirtyEnd(0), bufferSize(0) {
+    shader = SceneResourceManager::instance().get<AbstractShaderProgram, Shaders::InstancedPhong>("instanced-phong");
+
+    /* Share vertex and index data with the non-instanced mesh */
+    CORRADE_INTERNAL_ASSERT_OUTPUT(Application::instance()->meshResourceLoader().setupMesh(mesh, this->mesh));
+    this->mesh.addVertexBufferInstanced(instanceBuffer, 1, 0,
+        Shaders::InstancedPhong::TransformationMatrix(),
+        Shaders::InstancedPhong::Color());
+}
+
+std::size_t InstanceBatch::add(const Matrix4& transformation, const Color3& color) {
+    instances.push_back({transformation, color});
+    dirtyEnd = instances.size();
+    return instances.size() - 1;
+}
+
+void InstanceBatch::set(std::size_t id, const Matrix4& transformation, const Color3& color) {
+    CORRADE_INTERNAL_ASSERT(id < instances.size());
+    instances[id] = {transformation, color};
+
+    if(dirtyBegin == dirtyEnd) {
+        dirtyBegin = id;
+        dirtyEnd = id + 1;
+    } else {
+        dirtyBegin = Math::min(dirtyBegin, id);
+        dirtyEnd = Math::max(dirtyEnd, id + 1);
+    }
+}
+
+void InstanceBatch::draw(const Matrix4& transformationMatrix, SceneGraph::Camera3D&) {
+    if(instances.empty()) return;
+
+    /* Upload changed instance data. Reallocate the buffer if it grew,
+       otherwise update only the changed range. */
+    if(instances.size() != bufferSize) {
+        instanceBuffer.setData(instances, BufferUsage::DynamicDraw);
+        bufferSize = instances.size();
+        mesh.setInstanceCount(bufferSize);
+    } else if(dirtyBegin != dirtyEnd) {
+        instanceBuffer.setSubData(dirtyBegin*sizeof(Instance),
+            Containers::ArrayView<const Instance>{instances.data() + dirtyBegin, dirtyEnd - dirtyBegin});
+    }
+    dirtyBegin = dirtyEnd = 0;
+
+    /* Colors are per-instance, so there's no material */
+    drawTransformation = transformationMatrix;
+    Application::instance()->renderQueue().add(*shader, mesh, 0, *this);
+}
+
+UnsignedInt InstanceBatch::submit(UnsignedInt, bool) {
+    shader->setTransformationMatrix(drawTransformation)
+          /** @todo rotationNormalized() when precision problems are fixed */
+          .setNormalMatrix(drawTransformation.rotationScaling());
+
+    mesh.draw(*shader);
+    return 2;
+}
+
+}}
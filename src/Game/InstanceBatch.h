@@ -0,0 +1,75 @@
+#ifndef PushTheBox_Game_InstanceBatch_h
+#define PushTheBox_Game_InstanceBatch_h
+
+/** @file
+ * @brief Class PushTheBox::Game::InstanceBatch
+ */
+
+#include <vector>
+#include <Magnum/Buffer.h>
+#include <Magnum/Color.h>
+#include <Magnum/Mesh.h>
+#include <Magnum/ResourceManager.h>
+#include <Magnum/SceneGraph/Drawable.h>
+#include <Magnum/SceneGraph/DualQuaternionTransformation.h>
+
+#include "PushTheBox.h"
+#include "Rendering/RenderQueue.h"
+#include "Shaders/InstancedPhong.h"
+
+namespace PushTheBox { namespace Game {
+
+/**
+@brief Instanced batch of one mesh
+
+Draws all instances of given mesh with a single instanced draw call. Instance
+transformations are relative to the parent object, per-instance data are
+uploaded only when some instance changes and only the changed range.
+
+The batch is not added as an opaque packet to the render queue, so the
+instances are not in the depth pre-pass nor in the overdraw visualization.
+*/
+class InstanceBatch: public Object3D, SceneGraph::Drawable3D, Rendering::RenderQueue::Renderable {
+    public:
+        /** @brief Whether instanced rendering is supported */
+        static bool isSupported();
+
+        /**
+         * @brief Constructor
+         * @param mesh      Mesh resource name
+         * @param parent    Parent object
+         * @param drawables Drawable group
+         */
+        explicit InstanceBatch(ResourceKey mesh, Object3D* parent, SceneGraph::DrawableGroup3D* drawables);
+
+        /**
+         * @brief Add instance
+         * @return Instance ID
+         */
+        std::size_t add(const Matrix4& transformation, const Color3& color);
+
+        /** @brief Update instance */
+        void set(std::size_t id, const Matrix4& transformation, const Color3& color);
+
+        /** @seemagnum{SceneGraph::Drawable::draw()} */
+        void draw(const Matrix4& transformationMatrix, SceneGraph::Camera3D& camera) override;
+
+    private:
+        struct Instance {
+            Matrix4 transformation;
+            Color3 color;
+        };
+
+        UnsignedInt submit(UnsignedInt part, bool materialChanged) override;
+
+        Resource<AbstractShaderProgram, Shaders::InstancedPhong> shader;
+        std::vector<Instance> instances;
+        std::size_t dirtyBegin, dirtyEnd, bufferSize;
+        Buffer instanceBuffer;
+        Mesh mesh;
+        Matrix4 drawTransformation;
+};
+
+}}
+
+#endif
@@ -6,13 +6,22 @@
 #include <Magnum/Math/Vector2.h>
 #include <Magnum/SceneGraph/Scene.h>
 
-#include "FloorTile.h"
-#include "WallBrick.h"
 #include "Game/Box.h"
+#include "Game/InstanceBatch.h"
+#include "Game/StaticGeometry.h"
+#include "Rendering/CpuProfiler.h"
 
 namespace PushTheBox { namespace Game {
 
-Level::Level(const std::string& name, Scene3D* scene, SceneGraph::DrawableGroup3D* drawables, SceneGraph::AnimableGroup3D* animables): Object3D(scene), _name(name), _remainingTargets(0), _moves(0) {
+namespace {
+    const Color3 floorColor = Color3::fromHsv(Deg(60.0f), 0.1f, 0.8f);
+    const Color3 targetColor = Color3::fromHsv(Deg(120.0f), 1.0f, 0.6f);
+    const Color3 wallColor = Color3::fromHsv(Deg(30.0f), 0.2f, 1.0f);
+}
+
+Level::Level(const std::string& name, Scene3D* scene, SceneGraph::DrawableGroup3D* drawables): Object3D(scene), _name(name), _state{{}, {}, {}, {}, 0}, boxBatch(nullptr) {
+    PUSHTHEBOX_PROFILE_SCOPE("Level::Level");
+
     /* Get level data */
     Utility::Resource rs("PushTheBoxLevels");
     std::istringstream confIn(rs.get(name + ".conf"));
@@ -26,9 +35,17 @@ Level::Level(const std::string& name, Scene3D* scene, SceneGraph::DrawableGroup3
     _title = conf.value("title");
 
     /* Level size */
-    _size = conf.value<Vector2i>("size");
-    level.resize(_size.product(), TileType::Empty);
-    CORRADE_ASSERT((_size > Vector2i(3, 3)).all(), "Level" << name << "is too small:" << _size, );
+    _state.size = conf.value<Vector2i>("size");
+    _state.tiles.resize(_state.size.product(), TileType::Empty);
+    CORRADE_ASSERT((_state.size > Vector2i(3, 3)).all(), "Level" << name << "is too small:" << _state.size, );
+
+    /* Static tiles are merged into one mesh per material, boxes are drawn
+       with a single instanced draw, if possible */
+    floors = new StaticGeometry("floor-mesh", floorColor, this, drawables);
+    targets = new StaticGeometry("floor-target-mesh", targetColor, this, drawables);
+    walls = new StaticGeometry("wall-mesh", wallColor, this, drawables);
+    if(InstanceBatch::isSupported())
+        boxBatch = new InstanceBatch("box-mesh", this, drawables);
 
     /* Level data */
     std::istringstream in(conf.value("data"));
@@ -38,7 +55,7 @@ Level::Level(const std::string& name, Scene3D* scene, SceneGraph::DrawableGroup3
     std::size_t targetCount = 0;
 
     /* Parse the file */
-    _playerPosition = {-1, -1};
+    _state.playerPosition = {-1, -1};
     Vector2i position;
     while(in.peek() > 0) {
         TileType type = {};
@@ -51,8 +68,8 @@ Level::Level(const std::string& name, Scene3D* scene, SceneGraph::DrawableGroup3
 
             /* Starting position */
             case '@':
-                CORRADE_ASSERT(_playerPosition == Vector2i(-1, -1), "Multiple starting positions in level" << name, );
-                _playerPosition = position;
+                CORRADE_ASSERT(_state.playerPosition == Vector2i(-1, -1), "Multiple starting positions in level" << name, );
+                _state.playerPosition = position;
                 /* No break, as we need to mark it as floor */
 
             /* Floor */
@@ -66,15 +83,15 @@ Level::Level(const std::string& name, Scene3D* scene, SceneGraph::DrawableGroup3
 
             /* Starting position on target */
             case '+':
-                CORRADE_ASSERT(_playerPosition == Vector2i(-1, -1), "Multiple starting positions in level" << name, );
-                _playerPosition = position;
+                CORRADE_ASSERT(_state.playerPosition == Vector2i(-1, -1), "Multiple starting positions in level" << name, );
+                _state.playerPosition = position;
                 /* No break, as we need to mark it as target */
 
             /* Target */
             case '.':
                 type = TileType::Target;
                 ++targetCount;
-                ++_remainingTargets;
+                ++_state.remainingTargets;
                 break;
 
             /* Box on target */
@@ -96,102 +113,64 @@ Level::Level(const std::string& name, Scene3D* scene, SceneGraph::DrawableGroup3
         }
 
         in.ignore();
-        set(position, type, drawables, animables);
+        set(position, type, drawables);
         ++position.x();
     }
 
     /* Sanity checks */
-    CORRADE_ASSERT(_remainingTargets != 0, "Level is already solved", );
-    CORRADE_ASSERT(_playerPosition != Vector2i(-1, -1), "Level" << name << "has no starting position", );
+    CORRADE_ASSERT(_state.remainingTargets != 0, "Level is already solved", );
+    CORRADE_ASSERT(_state.playerPosition != Vector2i(-1, -1), "Level" << name << "has no starting position", );
     CORRADE_ASSERT(boxCount == targetCount, "Level" << name << "has" << boxCount << "boxes, but" << targetCount << "targets", );
-}
 
-bool Level::movePlayer(const Vector2i& direction) {
-    CORRADE_INTERNAL_ASSERT(direction.dot() == 1);
-    Vector2i newPosition = _playerPosition + direction;
-
-    /* Cannot move out of map */
-    if((newPosition < Vector2i()).any() || (newPosition >= size()).any())
-        return false;
-
-    /* Pushing box */
-    if(at(newPosition) == TileType::Box ||
-       at(newPosition) == TileType::BoxOnTarget) {
-        Vector2i newBoxPosition = _playerPosition + direction*2;
-
-        /* Cannot push box out of map */
-        if((newBoxPosition < Vector2i()).any() || (newBoxPosition >= size()).any())
-            return false;
-
-        /* The box can be pushed only on the floor */
-        if(at(newBoxPosition) != TileType::Floor &&
-           at(newBoxPosition) != TileType::Target)
-            return false;
-
-        /* Move the box */
-        Box* box = nullptr;
-        for(std::size_t i = 0; i < boxes.size(); ++i) {
-            if(boxes[i]->position == newPosition) {
-                box = boxes[i];
-                break;
-            }
-        }
-        CORRADE_INTERNAL_ASSERT(box);
-
-        box->translate(Math::swizzle<'x', '0', 'y'>(Vector2(direction)));
-        box->position += direction;
-
-        if(at(newPosition) == TileType::BoxOnTarget) {
-            remainingTargetsChanged(++_remainingTargets);
-            at(newPosition) = TileType::Target;
-        } else at(newPosition) = TileType::Floor;
-
-        if(at(newBoxPosition) == TileType::Target) {
-            remainingTargetsChanged(--_remainingTargets);
-            at(newBoxPosition) = TileType::BoxOnTarget;
-            if(box->type != Box::Type::OnTarget) {
-                box->type = Box::Type::OnTarget;
-                box->movedToTarget();
-            }
-        } else {
-            at(newBoxPosition) = TileType::Box;
-            if(box->type != Box::Type::OnFloor) {
-                box->type = Box::Type::OnFloor;
-                box->movedFromTarget();
-            }
-        }
+    /* Walls are added only now that all their neighbors are known, sides
+       shared with another wall are never visible */
+    for(Int y = 0; y != _state.size.y(); ++y) for(Int x = 0; x != _state.size.x(); ++x) {
+        if(at({x, y}) != TileType::Wall) continue;
+
+        StaticGeometry::Sides hiddenSides;
+        if(x != 0 && at({x - 1, y}) == TileType::Wall)
+            hiddenSides |= StaticGeometry::Side::NegativeX;
+        if(x != _state.size.x() - 1 && at({x + 1, y}) == TileType::Wall)
+            hiddenSides |= StaticGeometry::Side::PositiveX;
+        if(y != 0 && at({x, y - 1}) == TileType::Wall)
+            hiddenSides |= StaticGeometry::Side::NegativeZ;
+        if(y != _state.size.y() - 1 && at({x, y + 1}) == TileType::Wall)
+            hiddenSides |= StaticGeometry::Side::PositiveZ;
+        walls->add({x, y}, hiddenSides);
+    }
 
-    /* Other than that we can move on the floor, but nowhere else */
-    } else if(at(newPosition) != TileType::Floor &&
-              at(newPosition) != TileType::Target)
-        return false;
+    /* Upload the merged static geometry */
+    floors->build();
+    targets->build();
+    walls->build();
+}
 
-    /* Move the player */
-    _playerPosition = newPosition;
-    movesChanged(_moves += Math::abs(direction).sum());
-    return true;
+void Level::setBox(const std::size_t id, const Vector2i& position, const Color3& color) {
+    boxes[id]->set(position, color);
 }
 
-void Level::set(const Vector2i& position, TileType type, SceneGraph::DrawableGroup3D* drawables, SceneGraph::AnimableGroup3D* animables) {
+void Level::set(const Vector2i& position, TileType type, SceneGraph::DrawableGroup3D* drawables) {
     at(position) = type;
 
     switch(type) {
         case TileType::Empty:
             break;
         case TileType::Box:
-            boxes.push_back(new Box(position, Box::Type::OnFloor, this, drawables, animables));
+            boxes.push_back(new Box(position, Box::Type::OnFloor, this, drawables, boxBatch));
+            _state.boxes.push_back(position);
             /* No break, as we need floor tile under it */
         case TileType::Floor:
-            new FloorTile(position, FloorTile::Type::Floor, this, drawables);
+            floors->add(position);
             break;
         case TileType::BoxOnTarget:
-            boxes.push_back(new Box(position, Box::Type::OnTarget, this, drawables, animables));
+            boxes.push_back(new Box(position, Box::Type::OnTarget, this, drawables, boxBatch));
+            _state.boxes.push_back(position);
             /* No break, as we need target tile under it */
         case TileType::Target:
-            new FloorTile(position, FloorTile::Type::Target, this, drawables);
+            targets->add(position);
             break;
         case TileType::Wall:
-            new WallBrick(position, this, drawables);
+            /* Added after the whole level is parsed */
             break;
     }
 }
@@ -3,7 +3,8 @@
 
 #include <vector>
 #include <string>
-#include <Corrade/Interconnect/Emitter.h>
+#include <Magnum/Color.h>
+#include <Magnum/Math/Vector2.h>
 #include <Magnum/SceneGraph/DualQuaternionTransformation.h>
 
 #include "PushTheBox.h"
@@ -11,22 +12,38 @@
 namespace PushTheBox { namespace Game {
 
 class Box;
+class InstanceBatch;
+class StaticGeometry;
 
-/** @brief %Level */
-class Level: public Object3D, public Interconnect::Emitter {
+/**
+@brief %Level
+
+Parses the level and creates its drawables. The game logic runs on the
+simulation, which gets the initial @ref state() and its snapshots then move
+the boxes around via @ref setBox().
+*/
+class Level: public Object3D {
     public:
         enum class TileType {
             Empty = 0, Floor, Box, Wall, Target, BoxOnTarget
         };
 
+        /** @brief Logical state of the level */
+        struct State {
+            std::vector<TileType> tiles;    /**< Tiles, row by row */
+            Vector2i size;                  /**< Level size */
+            Vector2i playerPosition;        /**< Player position */
+            std::vector<Vector2i> boxes;    /**< Box positions */
+            UnsignedInt remainingTargets;   /**< Remaining targets */
+        };
+
         /**
          * @brief Constructor
          * @param name          Level name
          * @param scene         Scene to which to add the level
          * @param drawables     Drawable group
-         * @param animables     Animable group
          */
-        Level(const std::string& name, Scene3D* scene, SceneGraph::DrawableGroup3D* drawables, SceneGraph::AnimableGroup3D* animables);
+        Level(const std::string& name, Scene3D* scene, SceneGraph::DrawableGroup3D* drawables);
 
         /** @brief Level name */
         inline std::string name() const { return _name; }
@@ -38,45 +55,38 @@ class Level: public Object3D, public Interconnect::Emitter {
         std::string title() const { return _title; }
 
         /** @brief Level size */
-        inline Vector2i size() const { return _size; }
-
-        /** @brief Player position */
-        inline Vector2i playerPosition() { return _playerPosition; }
-
-        /** @brief Remaining targets */
-        inline UnsignedInt remainingTargets() const { return _remainingTargets; }
-
-        /** @brief Remaining targets changed */
-        inline Signal remainingTargetsChanged(UnsignedInt count) {
-            return emit<Level, UnsignedInt>(&Level::remainingTargetsChanged, count);
-        }
+        inline Vector2i size() const { return _state.size; }
 
-        /** @brief Player moves */
-        inline UnsignedInt moves() const { return _moves; }
-
-        /** @brief Player moves changed */
-        inline Signal movesChanged(UnsignedInt count) {
-            return emit<Level, UnsignedInt>(&Level::movesChanged, count);
-        }
+        /**
+         * @brief Initial state
+         *
+         * Boxes are in the same order as in @ref setBox().
+         */
+        inline const State& state() const { return _state; }
 
         /**
-         * @brief Move player in given direction
-         * @return `True` if the player moved, `false` otherwise
+         * @brief Move and recolor a box
+         *
+         * Does nothing if neither the position nor the color changed.
          */
-        bool movePlayer(const Vector2i& direction);
+        void setBox(std::size_t id, const Vector2i& position, const Color3& color);
 
     private:
-        void set(const Vector2i& position, TileType type, SceneGraph::DrawableGroup3D* drawables, SceneGraph::AnimableGroup3D* animables);
+        void set(const Vector2i& position, TileType type, SceneGraph::DrawableGroup3D* drawables);
 
         inline TileType& at(const Vector2i& position) {
-            return level[position.y()*_size.x()+position.x()];
+            return _state.tiles[position.y()*_state.size.x()+position.x()];
         }
 
         std::string _name, _nextName, _title;
-        Vector2i _size, _playerPosition;
-        UnsignedInt _remainingTargets, _moves;
-        std::vector<TileType> level;
+        State _state;
         std::vector<Box*> boxes;
+
+        /* Tiles which never move, merged into one mesh per material */
+        StaticGeometry *floors, *targets, *walls;
+
+        /* Instanced boxes, if supported */
+        InstanceBatch* boxBatch;
 };
 
 }}
@@ -1,26 +1,40 @@
 #include "Player.h"
 
 #include <Magnum/Mesh.h>
-#include <Magnum/Shaders/Phong.h>
+
+#include "Application.h"
+#include "Shaders/CachedPhong.h"
 
 namespace PushTheBox { namespace Game {
 
+namespace {
+    const Color3 headColor = Color3::fromHsv(Deg(210.0f), 0.85f, 0.8f);
+    const Color3 bodyColor = Color3::fromHsv(Deg(50.0f), 0.85f, 0.8f);
+}
+
 Player::Player(Object3D* parent, SceneGraph::DrawableGroup3D* drawables): Object3D(parent), SceneGraph::Drawable3D(*this, drawables) {
     /* Get shader and mesh buffer */
-    shader = SceneResourceManager::instance().get<AbstractShaderProgram, Shaders::Phong>("phong");
+    shader = SceneResourceManager::instance().get<AbstractShaderProgram, Shaders::CachedPhong>("phong");
     mesh = SceneResourceManager::instance().get<Mesh>("player-mesh");
     bodyMesh = SceneResourceManager::instance().get<Mesh>("player-body-mesh");
 }
 
 void Player::draw(const Matrix4& transformationMatrix, SceneGraph::Camera3D&) {
-    shader->setTransformationMatrix(transformationMatrix)
-          /** @todo rotationNormalized() when precision problems are fixed */
-          .setNormalMatrix(transformationMatrix.rotationScaling());
-
-    shader->setDiffuseColor(Color3::fromHsv(Deg(210.0f), 0.85f, 0.8f));
-    mesh->draw(*shader);
-    shader->setDiffuseColor(Color3::fromHsv(Deg(50.0f), 0.85f, 0.8f));
-    bodyMesh->draw(*shader);
+    drawTransformation = transformationMatrix;
+
+    const Float distance = transformationMatrix.translation().length();
+    Rendering::RenderQueue& queue = Application::instance()->renderQueue();
+    queue.addOpaque(*shader, *mesh, Rendering::RenderQueue::material(headColor), *this, drawTransformation, distance, 0);
+    queue.addOpaque(*shader, *bodyMesh, Rendering::RenderQueue::material(bodyColor), *this, drawTransformation, distance, 1);
+}
+
+UnsignedInt Player::submit(UnsignedInt part, bool) {
+    const UnsignedInt uploadCount = shader->uploadCount();
+    shader->setTransformation(drawTransformation)
+          .setDiffuseColor(part == 0 ? headColor : bodyColor);
+
+    (part == 0 ? *mesh : *bodyMesh).draw(*shader);
+    return shader->uploadCount() - uploadCount;
 }
 
 }}
@@ -8,14 +8,20 @@
 #include <Magnum/ResourceManager.h>
 #include <Magnum/SceneGraph/Drawable.h>
 #include <Magnum/SceneGraph/DualQuaternionTransformation.h>
-#include <Magnum/Shaders/Shaders.h>
 
 #include "PushTheBox.h"
+#include "Rendering/RenderQueue.h"
 
-namespace PushTheBox { namespace Game {
+namespace PushTheBox {
+
+namespace Shaders {
+    class CachedPhong;
+}
+
+namespace Game {
 
 /** @brief %Player */
-class Player: public Object3D, SceneGraph::Drawable3D {
+class Player: public Object3D, SceneGraph::Drawable3D, Rendering::RenderQueue::Renderable {
     public:
         /**
          * @brief Constructor
@@ -28,8 +34,11 @@ class Player: public Object3D, SceneGraph::Drawable3D {
         void draw(const Matrix4& transformationMatrix, SceneGraph::Camera3D& camera) override;
 
     private:
-        Resource<AbstractShaderProgram, Magnum::Shaders::Phong> shader;
+        UnsignedInt submit(UnsignedInt part, bool materialChanged) override;
+
+        Resource<AbstractShaderProgram, Shaders::CachedPhong> shader;
         Resource<Mesh> mesh, bodyMesh;
+        Matrix4 drawTransformation;
 };
 
 }}
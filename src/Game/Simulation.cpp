@@ -0,0 +1,359 @@
+#include "Simulation.h"
+
+#include <chrono>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Swizzle.h>
+#include <Magnum/SceneGraph/Animable.h>
+#include <Magnum/SceneGraph/AnimableGroup.h>
+#include <Magnum/SceneGraph/Scene.h>
+
+#include "Game/Box.h"
+#include "Rendering/CpuProfiler.h"
+
+namespace PushTheBox { namespace Game {
+
+namespace {
+    #ifdef PUSHTHEBOX_WITH_SIMULATION_THREAD
+    /* How often snapshots are published while something is animating */
+    constexpr std::chrono::milliseconds StepInterval{4};
+    #endif
+
+    /* Box animating its color when moved to or from target */
+    class SimulatedBox: public Object3D, public SceneGraph::Animable3D {
+        public:
+            explicit SimulatedBox(const Vector2i& position, Box::Type type, Object3D* parent, SceneGraph::AnimableGroup3D* animables): Object3D(parent), SceneGraph::Animable3D(*this, animables), position(position), type(type), color(Box::color(type)) {
+                setDuration(0.375f);
+            }
+
+            void setType(Box::Type type) {
+                if(type == this->type) return;
+                this->type = type;
+                setState(SceneGraph::AnimationState::Running);
+            }
+
+            Vector2i position;
+            Box::Type type;
+            Color3 color;
+
+        protected:
+            void animationStep(Float time, Float) override {
+                const Box::Type previous = type == Box::Type::OnFloor ? Box::Type::OnTarget : Box::Type::OnFloor;
+                color = Math::lerp(Box::color(previous), Box::color(type), time/duration());
+            }
+
+            void animationStopped() override {
+                color = Box::color(type);
+            }
+    };
+
+    /* Pulse of the remaining targets counter when the count changes */
+    class TargetsPulse: public Object3D, public SceneGraph::Animable3D {
+        public:
+            explicit TargetsPulse(Object3D* parent, SceneGraph::AnimableGroup3D* animables): Object3D(parent), SceneGraph::Animable3D(*this, animables), scale(1.0f) {
+                setDuration(0.4f);
+                setRepeated(true);
+                setRepeatCount(2);
+            }
+
+            Float scale;
+
+        protected:
+            void animationStep(Float time, Float) override {
+                scale = 1.0f + Math::sin(Rad(Constants::pi()*time/duration()))*0.35f;
+            }
+
+            void animationStopped() override {
+                scale = 1.0f;
+            }
+    };
+}
+
+/* Accessed only from the simulation thread, except for construction */
+struct Simulation::State {
+    explicit State(const DualQuaternion& cameraTransformation);
+
+    inline Level::TileType& at(const Vector2i& position) {
+        return tiles[position.y()*size.x()+position.x()];
+    }
+
+    inline bool isAnimating() const { return animables.runningCount(); }
+
+    void apply(Command& command);
+    void load(UnsignedInt id, Level::State&& state, Deg playerRotation);
+    bool movePlayer(const Vector2i& direction);
+    void walkForward();
+    void look(const Vector2i& relativePosition);
+    void step();
+
+    Scene3D scene;
+    SceneGraph::AnimableGroup3D animables;
+    Object3D *player, *camera, *level;
+    TargetsPulse* pulse;
+    std::vector<SimulatedBox*> boxes;
+
+    std::vector<Level::TileType> tiles;
+    Vector2i size, playerPosition;
+    UnsignedInt levelId, remainingTargets, moves;
+    UnsignedLong sequence;
+
+    std::chrono::steady_clock::time_point start, previous;
+};
+
+Simulation::State::State(const DualQuaternion& cameraTransformation): player(new Object3D(&scene)), camera(new Object3D(player)), level(new Object3D(&scene)), pulse(new TargetsPulse(&scene, &animables)), levelId(0), remainingTargets(0), moves(0), sequence(0), start(std::chrono::steady_clock::now()), previous(start) {
+    camera->setTransformation(cameraTransformation);
+}
+
+void Simulation::State::apply(Command& command) {
+    switch(command.type) {
+        case Command::Type::Load:
+            load(command.level, std::move(command.levelState), command.angle);
+            break;
+        case Command::Type::WalkForward:
+            walkForward();
+            break;
+        case Command::Type::Move:
+            movePlayer(command.direction);
+            break;
+        case Command::Type::Look:
+            look(command.direction);
+            break;
+        case Command::Type::Rotate:
+            player->setTransformation(DualQuaternion::translation(player->transformation().translation())*DualQuaternion::rotation(command.angle, Vector3::yAxis()));
+            break;
+    }
+
+    sequence = command.sequence;
+}
+
+void Simulation::State::load(const UnsignedInt id, Level::State&& state, const Deg playerRotation) {
+    PUSHTHEBOX_PROFILE_SCOPE("Simulation::load");
+
+    levelId = id;
+    tiles = std::move(state.tiles);
+    size = state.size;
+    playerPosition = state.playerPosition;
+    remainingTargets = state.remainingTargets;
+    moves = 0;
+
+    /* Replace the boxes */
+    delete level;
+    level = new Object3D(&scene);
+    boxes.clear();
+    for(const Vector2i& position: state.boxes)
+        boxes.push_back(new SimulatedBox(position, at(position) == Level::TileType::BoxOnTarget ? Game::Box::Type::OnTarget : Game::Box::Type::OnFloor, level, &animables));
+
+    player->setTransformation(DualQuaternion::translation(Math::swizzle<'x', '0', 'y'>(Vector2(playerPosition)))*DualQuaternion::rotation(playerRotation, Vector3::yAxis()));
+    pulse->setState(SceneGraph::AnimationState::Running);
+}
+
+bool Simulation::State::movePlayer(const Vector2i& direction) {
+    CORRADE_INTERNAL_ASSERT(direction.dot() == 1);
+    Vector2i newPosition = playerPosition + direction;
+
+    /* Cannot move out of map */
+    if((newPosition < Vector2i()).any() || (newPosition >= size).any())
+        return false;
+
+    /* Pushing box */
+    if(at(newPosition) == Level::TileType::Box ||
+       at(newPosition) == Level::TileType::BoxOnTarget) {
+        Vector2i newBoxPosition = playerPosition + direction*2;
+
+        /* Cannot push box out of map */
+        if((newBoxPosition < Vector2i()).any() || (newBoxPosition >= size).any())
+            return false;
+
+        /* The box can be pushed only on the floor */
+        if(at(newBoxPosition) != Level::TileType::Floor &&
+           at(newBoxPosition) != Level::TileType::Target)
+            return false;
+
+        /* Move the box */
+        SimulatedBox* box = nullptr;
+        for(std::size_t i = 0; i < boxes.size(); ++i) {
+            if(boxes[i]->position == newPosition) {
+                box = boxes[i];
+                break;
+            }
+        }
+        CORRADE_INTERNAL_ASSERT(box);
+
+        box->position += direction;
+
+        if(at(newPosition) == Level::TileType::BoxOnTarget) {
+            ++remainingTargets;
+            pulse->setState(SceneGraph::AnimationState::Running);
+            at(newPosition) = Level::TileType::Target;
+        } else at(newPosition) = Level::TileType::Floor;
+
+        if(at(newBoxPosition) == Level::TileType::Target) {
+            --remainingTargets;
+            pulse->setState(SceneGraph::AnimationState::Running);
+            at(newBoxPosition) = Level::TileType::BoxOnTarget;
+            box->setType(Game::Box::Type::OnTarget);
+        } else {
+            at(newBoxPosition) = Level::TileType::Box;
+            box->setType(Game::Box::Type::OnFloor);
+        }
+
+    /* Other than that we can move on the floor, but nowhere else */
+    } else if(at(newPosition) != Level::TileType::Floor &&
+              at(newPosition) != Level::TileType::Target)
+        return false;
+
+    /* Move the player */
+    playerPosition = newPosition;
+    moves += Math::abs(direction).sum();
+    player->translate(Math::swizzle<'x', '0', 'y'>(Vector2(direction)));
+    return true;
+}
+
+void Simulation::State::walkForward() {
+    Vector3 direction = player->transformation().rotation().transformVectorNormalized(Vector3::zAxis());
+    Deg angle = Math::angle(Vector3::zAxis(), direction);
+
+    if(angle < Deg(30.0f))
+        movePlayer({0, -1});
+    else if(angle > Deg(60.0f) && angle < Deg(120.0f))
+        movePlayer({direction.x() > 0 ? -1 : 1, 0});
+    else if(angle > Deg(150.0f))
+        movePlayer({0, 1});
+}
+
+void Simulation::State::look(const Vector2i& relativePosition) {
+    /** @todo mouse sensitivity */
+    player->normalizeRotation().rotateYLocal(-Rad(Constants::pi())*relativePosition.x()/500.0f);
+
+    Rad angle(-Constants::pi()*relativePosition.y()/500.0f);
+    DualQuaternion xRotation = DualQuaternion::rotation(angle, Vector3::xAxis())*camera->transformation();
+
+    /* Don't rotate under the floor */
+    if(Math::abs(Math::dot(xRotation.real().transformVector(Vector3::yAxis()), Vector3(0.0f, 1.0f, -1.0f).normalized())) > 0.75f)
+        camera->setTransformation(xRotation.normalized());
+}
+
+void Simulation::State::step() {
+    PUSHTHEBOX_PROFILE_SCOPE("Simulation::step");
+
+    /* Time is taken directly from the clock, so animations started after a
+       long idle period don't skip to their end */
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    animables.step(std::chrono::duration<Float>(now - start).count(), std::chrono::duration<Float>(now - previous).count());
+    previous = now;
+}
+
+Simulation::Simulation(const DualQuaternion& camera): sequence(0), state(new State(camera))
+    #ifdef PUSHTHEBOX_WITH_SIMULATION_THREAD
+    , quit(false), thread(&Simulation::run, this)
+    #endif
+    {}
+
+Simulation::~Simulation() {
+    #ifdef PUSHTHEBOX_WITH_SIMULATION_THREAD
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+    }
+    condition.notify_one();
+    thread.join();
+    #endif
+}
+
+UnsignedLong Simulation::load(const UnsignedInt level, Level::State state, const Deg playerRotation) {
+    Command command{Command::Type::Load, 0, {}, playerRotation, level, std::move(state)};
+    return submit(std::move(command));
+}
+
+UnsignedLong Simulation::walkForward() {
+    return submit({Command::Type::WalkForward, 0, {}, {}, 0, {}});
+}
+
+UnsignedLong Simulation::movePlayer(const Vector2i& direction) {
+    return submit({Command::Type::Move, 0, direction, {}, 0, {}});
+}
+
+UnsignedLong Simulation::look(const Vector2i& relativePosition) {
+    return submit({Command::Type::Look, 0, relativePosition, {}, 0, {}});
+}
+
+UnsignedLong Simulation::setPlayerRotation(const Deg angle) {
+    return submit({Command::Type::Rotate, 0, {}, angle, 0, {}});
+}
+
+UnsignedLong Simulation::submit(Command&& command) {
+    command.sequence = ++sequence;
+
+    #ifdef PUSHTHEBOX_WITH_SIMULATION_THREAD
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        commands.push_back(std::move(command));
+    }
+    condition.notify_one();
+    #else
+    state->apply(command);
+    state->step();
+    publish();
+    #endif
+
+    return sequence;
+}
+
+void Simulation::update() {
+    #ifndef PUSHTHEBOX_WITH_SIMULATION_THREAD
+    if(!state->isAnimating()) return;
+    state->step();
+    publish();
+    #endif
+}
+
+void Simulation::synchronize() {
+    #ifdef PUSHTHEBOX_WITH_SIMULATION_THREAD
+    while(fetch(), snapshot().sequence < sequence)
+        std::this_thread::yield();
+    #else
+    fetch();
+    #endif
+}
+
+void Simulation::publish() {
+    Snapshot& snapshot = snapshots.write();
+    snapshot.level = state->levelId;
+    snapshot.sequence = state->sequence;
+    snapshot.player = state->player->transformation();
+    snapshot.camera = state->camera->transformation();
+    snapshot.boxes.resize(state->boxes.size());
+    for(std::size_t i = 0; i != state->boxes.size(); ++i)
+        snapshot.boxes[i] = {state->boxes[i]->position, state->boxes[i]->color};
+    snapshot.moves = state->moves;
+    snapshot.remainingTargets = state->remainingTargets;
+    snapshot.remainingTargetsScale = state->pulse->scale;
+    snapshot.animating = state->isAnimating();
+    snapshots.publish();
+}
+
+#ifdef PUSHTHEBOX_WITH_SIMULATION_THREAD
+void Simulation::run() {
+    std::vector<Command> pending;
+    for(;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+
+            /* Sleep until the next command, while animating wake up
+               periodically to publish the animation progress */
+            const auto ready = [this]() { return quit || !commands.empty(); };
+            if(state->isAnimating()) condition.wait_for(lock, StepInterval, ready);
+            else condition.wait(lock, ready);
+            if(quit) return;
+
+            std::swap(commands, pending);
+        }
+
+        for(Command& command: pending) state->apply(command);
+        pending.clear();
+        state->step();
+        publish();
+    }
+}
+#endif
+
+}}
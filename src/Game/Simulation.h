@@ -0,0 +1,187 @@
+#ifndef PushTheBox_Game_Simulation_h
+#define PushTheBox_Game_Simulation_h
+
+/** @file
+ * @brief Class PushTheBox::Game::Simulation
+ */
+
+#include <memory>
+#include <vector>
+#include <Magnum/Color.h>
+#include <Magnum/Math/DualQuaternion.h>
+#include <Magnum/Math/Vector2.h>
+
+#include "configure.h"
+#include "PushTheBox.h"
+#include "Game/Level.h"
+#include "Rendering/TripleBuffer.h"
+
+#ifdef PUSHTHEBOX_WITH_SIMULATION_THREAD
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace PushTheBox { namespace Game {
+
+/**
+@brief Game simulation
+
+Owns the game logic: player and box movement, looking around and the
+animations of box colors and of the remaining targets counter. Input is
+submitted as commands from the main thread and applied on a simulation
+thread, which after each change publishes an immutable @ref Snapshot through
+a lock-free @ref Rendering::TripleBuffer. The main thread only takes the
+newest snapshot when drawing, so no game logic ever delays a frame.
+
+While something is animating the snapshots are published every few
+milliseconds, otherwise the simulation thread sleeps until the next command.
+On platforms without threads the commands are applied immediately and the
+animations are stepped in @ref update().
+*/
+class Simulation {
+    public:
+        /** @brief Box state */
+        struct Box {
+            Vector2i position;      /**< Position in level */
+            Color3 color;           /**< Color */
+        };
+
+        /** @brief Snapshot of the simulation state */
+        struct Snapshot {
+            /** @brief Level ID passed to @ref load(), `0` before any level */
+            UnsignedInt level = 0;
+
+            /** @brief Sequence number of the last applied command */
+            UnsignedLong sequence = 0;
+
+            DualQuaternion player;          /**< Player transformation */
+            DualQuaternion camera;          /**< Camera transformation relative to player */
+            std::vector<Box> boxes;         /**< Boxes in order of @ref Level::State::boxes */
+            UnsignedInt moves = 0;          /**< Player moves */
+            UnsignedInt remainingTargets = 0; /**< Remaining targets */
+            Float remainingTargetsScale = 1.0f; /**< Scale of remaining targets counter */
+            bool animating = false;         /**< Whether anything is animating */
+        };
+
+        /**
+         * @brief Constructor
+         * @param camera    Initial camera transformation relative to player
+         *
+         * Starts the simulation thread, if supported.
+         */
+        explicit Simulation(const DualQuaternion& camera);
+
+        /** @brief Copying is not allowed */
+        Simulation(const Simulation&) = delete;
+
+        /**
+         * @brief Destructor
+         *
+         * Waits for the simulation thread to finish.
+         */
+        ~Simulation();
+
+        /** @brief Copying is not allowed */
+        Simulation& operator=(const Simulation&) = delete;
+
+        /**
+         * @brief Load level
+         * @param level             Level ID, used to recognize snapshots
+         *      of this level
+         * @param state             Initial level state
+         * @param playerRotation    Initial player rotation
+         *
+         * All commands return their sequence number, compare it with
+         * @ref Snapshot::sequence to see whether the command was applied.
+         */
+        UnsignedLong load(UnsignedInt level, Level::State state, Deg playerRotation);
+
+        /**
+         * @brief Walk forward
+         *
+         * Moves the player in the level axis closest to the direction it's
+         * facing, if any of them is close enough.
+         */
+        UnsignedLong walkForward();
+
+        /** @brief Move player in given direction */
+        UnsignedLong movePlayer(const Vector2i& direction);
+
+        /** @brief Rotate player and camera by relative mouse movement */
+        UnsignedLong look(const Vector2i& relativePosition);
+
+        /** @brief Rotate the player in place */
+        UnsignedLong setPlayerRotation(Deg angle);
+
+        /** @brief Sequence number of the last submitted command */
+        inline UnsignedLong submittedSequence() const { return sequence; }
+
+        /**
+         * @brief Step animations
+         *
+         * Called each frame from the main thread. Does nothing if the
+         * simulation has its own thread.
+         */
+        void update();
+
+        /**
+         * @brief Take the newest snapshot
+         * @return `true` if there was a new snapshot since the last call,
+         *      `false` otherwise
+         */
+        inline bool fetch() { return snapshots.update(); }
+
+        /** @brief Snapshot taken by the last @ref fetch() */
+        inline const Snapshot& snapshot() const { return snapshots.read(); }
+
+        /**
+         * @brief Wait until all submitted commands are applied
+         *
+         * Fetches snapshots until there's one with all submitted commands
+         * applied. For scripted views, which need to draw the result of
+         * the commands in the very next frame.
+         */
+        void synchronize();
+
+    private:
+        struct Command {
+            enum class Type: UnsignedByte {
+                Load, WalkForward, Move, Look, Rotate
+            };
+
+            Type type;
+            UnsignedLong sequence;
+            Vector2i direction;     /* Move direction or mouse movement */
+            Deg angle;              /* Player rotation */
+            UnsignedInt level;
+            Level::State levelState;
+        };
+
+        struct State;
+
+        UnsignedLong submit(Command&& command);
+        void publish();
+
+        #ifdef PUSHTHEBOX_WITH_SIMULATION_THREAD
+        void run();
+        #endif
+
+        UnsignedLong sequence;
+        std::unique_ptr<State> state;
+        Rendering::TripleBuffer<Snapshot> snapshots;
+
+        #ifdef PUSHTHEBOX_WITH_SIMULATION_THREAD
+        std::mutex mutex;
+        std::condition_variable condition;
+        bool quit;
+        std::vector<Command> commands;
+
+        /* Must be last so it starts after everything above is initialized */
+        std::thread thread;
+        #endif
+};
+
+}}
+
+#endif
@@ -0,0 +1,251 @@
+#include "StaticGeometry.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <Magnum/Context.h>
+#include <Magnum/Extensions.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Range.h>
+#include <Magnum/Shaders/Phong.h>
+
+#include "Application.h"
+#include "Game/Camera.h"
+#include "Shaders/CachedPhong.h"
+
+namespace PushTheBox { namespace Game {
+
+struct StaticGeometry::Lod {
+    Buffer vertices{Buffer::TargetHint::Array}, indices{Buffer::TargetHint::ElementArray};
+    Mesh mesh;
+};
+
+namespace {
+
+/* Full detail and at most two simplified versions */
+constexpr UnsignedInt MaxLodCount = 3;
+
+/* Size of culled chunk in level cells */
+constexpr Int ChunkSize = 8;
+
+/* Sides are not completely flat, triangles closer than this to a side of the
+   bounds and facing outwards are considered to be lying on it */
+constexpr Float SideTolerance = 0.02f;
+
+UnsignedInt sourceIndex(const ResourceManagement::MeshResourceLoader::MeshData& data, std::size_t i) {
+    switch(data.indexType) {
+        case Mesh::IndexType::UnsignedByte:
+            return reinterpret_cast<const UnsignedByte*>(data.indices.data())[i];
+        case Mesh::IndexType::UnsignedShort:
+            return reinterpret_cast<const UnsignedShort*>(data.indices.data())[i];
+        case Mesh::IndexType::UnsignedInt:
+            return reinterpret_cast<const UnsignedInt*>(data.indices.data())[i];
+    }
+
+    return 0;
+}
+
+Vector3 sourcePosition(const ResourceManagement::MeshResourceLoader::MeshData& data, std::size_t i) {
+    Vector3 position;
+    std::memcpy(&position, data.vertices.data() + i*data.vertexStride, sizeof(Vector3));
+    return position;
+}
+
+/* Side of the bounds on which each triangle lies, if any */
+std::vector<StaticGeometry::Sides> triangleSides(const ResourceManagement::MeshResourceLoader::MeshData& data, const Range3D& bounds) {
+    std::vector<StaticGeometry::Sides> sides(data.primitive == MeshPrimitive::Triangles ? data.indexCount/3 : 0);
+
+    for(std::size_t i = 0; i != sides.size(); ++i) {
+        const Vector3 a = sourcePosition(data, sourceIndex(data, i*3 + 0));
+        const Vector3 b = sourcePosition(data, sourceIndex(data, i*3 + 1));
+        const Vector3 c = sourcePosition(data, sourceIndex(data, i*3 + 2));
+        const Vector3 normal = Math::cross(b - a, c - a);
+        const Vector3 min = Math::min(Math::min(a, b), c);
+        const Vector3 max = Math::max(Math::max(a, b), c);
+
+        if(normal.x() < 0.0f && max.x() < bounds.min().x() + SideTolerance)
+            sides[i] |= StaticGeometry::Side::NegativeX;
+        else if(normal.x() > 0.0f && min.x() > bounds.max().x() - SideTolerance)
+            sides[i] |= StaticGeometry::Side::PositiveX;
+        else if(normal.z() < 0.0f && max.z() < bounds.min().z() + SideTolerance)
+            sides[i] |= StaticGeometry::Side::NegativeZ;
+        else if(normal.z() > 0.0f && min.z() > bounds.max().z() - SideTolerance)
+            sides[i] |= StaticGeometry::Side::PositiveZ;
+    }
+
+    return sides;
+}
+
+/* Copies of the mesh offset by given translations, indices of copy `i` are
+   offset by `i*vertexCount`. Triangles on hidden sides of each copy are left
+   out. */
+template<class T> void merge(const ResourceManagement::MeshResourceLoader::MeshData& data, const std::vector<StaticGeometry::Sides>& sides, const Vector3* translations, const StaticGeometry::Sides* hiddenSides, std::size_t count, Buffer& vertexBuffer, Buffer& indexBuffer, Mesh& mesh, Mesh::IndexType indexType) {
+    std::vector<char> vertices(count*data.vertices.size());
+    std::vector<T> indices;
+    indices.reserve(count*data.indexCount);
+
+    for(std::size_t i = 0; i != count; ++i) {
+        char* const out = vertices.data() + i*data.vertices.size();
+        std::memcpy(out, data.vertices.data(), data.vertices.size());
+
+        /* Positions are the first attribute of each vertex */
+        for(std::size_t v = 0; v != data.vertexCount; ++v) {
+            Vector3 position;
+            std::memcpy(&position, out + v*data.vertexStride, sizeof(Vector3));
+            position += translations[i];
+            std::memcpy(out + v*data.vertexStride, &position, sizeof(Vector3));
+        }
+
+        for(std::size_t j = 0; j != data.indexCount; ++j) {
+            if(!sides.empty() && (sides[j/3] & hiddenSides[i])) continue;
+            indices.push_back(T(sourceIndex(data, j) + i*data.vertexCount));
+        }
+    }
+
+    vertexBuffer.setData({vertices.data(), vertices.size()}, BufferUsage::StaticDraw);
+    indexBuffer.setData({indices.data(), indices.size()*sizeof(T)}, BufferUsage::StaticDraw);
+
+    mesh.setPrimitive(data.primitive)
+        .setCount(indices.size())
+        .setIndexBuffer(indexBuffer, 0, indexType, 0, count*data.vertexCount - 1)
+        .addVertexBuffer(vertexBuffer, 0,
+            Magnum::Shaders::Phong::Position(),
+            Magnum::Shaders::Phong::Normal(Magnum::Shaders::Phong::Normal::DataType::Byte, Magnum::Shaders::Phong::Normal::DataOption::Normalized),
+            1);
+}
+
+}
+
+StaticGeometry::StaticGeometry(const std::string& mesh, const Color3& color, Object3D* parent, SceneGraph::DrawableGroup3D* drawables): Object3D(parent), SceneGraph::Drawable3D(*this, drawables), mesh(mesh), color(color) {
+    shader = SceneResourceManager::instance().get<AbstractShaderProgram, Shaders::CachedPhong>("phong");
+}
+
+StaticGeometry::~StaticGeometry() = default;
+
+void StaticGeometry::add(const Vector2i& position, Sides hiddenSides) {
+    copies.push_back({position, hiddenSides});
+}
+
+struct StaticGeometry::Part {
+    Range3D bounds;
+    Lod lods[MaxLodCount];
+    UnsignedInt lodCount, currentLod;
+};
+
+void StaticGeometry::build() {
+    CORRADE_ASSERT(parts.empty(), "Game::StaticGeometry::build(): already built", );
+    if(copies.empty()) return;
+
+    /* Full mesh and all its simplified versions */
+    ResourceManagement::MeshResourceLoader& loader = Application::instance()->meshResourceLoader();
+    ResourceManagement::MeshResourceLoader::MeshData data[MaxLodCount];
+    UnsignedInt lodCount = 0;
+    for(; lodCount != MaxLodCount; ++lodCount) {
+        const std::string name = lodCount ? mesh + "-lod" + char('0' + lodCount) : mesh;
+        if(!loader.contains(name)) break;
+        CORRADE_INTERNAL_ASSERT_OUTPUT(loader.meshData(name, data[lodCount]));
+        CORRADE_ASSERT(data[lodCount].indexCount, "Game::StaticGeometry::build(): only indexed meshes are supported", );
+    }
+    CORRADE_ASSERT(lodCount, "Game::StaticGeometry::build(): mesh" << mesh << "not found", );
+
+    /* Bounds of single copy of the mesh */
+    Vector3 min{Constants::inf()}, max{-Constants::inf()};
+    for(std::size_t v = 0; v != data[0].vertexCount; ++v) {
+        const Vector3 position = sourcePosition(data[0], v);
+        min = Math::min(min, position);
+        max = Math::max(max, position);
+    }
+
+    /* Triangles which can be hidden by neighbors */
+    std::vector<Sides> sides[MaxLodCount];
+    for(UnsignedInt lod = 0; lod != lodCount; ++lod)
+        sides[lod] = triangleSides(data[lod], {min, max});
+
+    /* Sort the copies by chunk so each chunk is contiguous */
+    std::sort(copies.begin(), copies.end(), [](const Copy& a, const Copy& b) {
+        const Vector2i chunkA = a.position/ChunkSize, chunkB = b.position/ChunkSize;
+        return chunkA.y() < chunkB.y() || (chunkA.y() == chunkB.y() && chunkA.x() < chunkB.x());
+    });
+
+    /* Everything in a chunk can be in one part, if 32-bit indices are
+       available. Otherwise the chunks are split into parts addressable with
+       16-bit indices, the full detail mesh has the most vertices. */
+    std::size_t copiesPerPart = copies.size();
+    Mesh::IndexType indexType = Mesh::IndexType::UnsignedInt;
+    #ifdef MAGNUM_TARGET_GLES2
+    if(!Context::current().isExtensionSupported<Extensions::GL::OES::element_index_uint>()) {
+        copiesPerPart = Math::max(std::size_t(65536/data[0].vertexCount), std::size_t(1));
+        indexType = Mesh::IndexType::UnsignedShort;
+    }
+    #endif
+
+    std::vector<Vector3> translations;
+    std::vector<Sides> hiddenSides;
+    for(std::size_t begin = 0; begin != copies.size(); ) {
+        /* End of current part, either at chunk boundary or at part size */
+        const Vector2i chunk = copies[begin].position/ChunkSize;
+        std::size_t end = begin;
+        while(end != copies.size() && end - begin != copiesPerPart && copies[end].position/ChunkSize == chunk)
+            ++end;
+
+        parts.emplace_back(new Part);
+        Part& part = *parts.back();
+        part.lodCount = lodCount;
+        part.currentLod = 0;
+
+        translations.clear();
+        hiddenSides.clear();
+        Vector3 partMin{Constants::inf()}, partMax{-Constants::inf()};
+        for(std::size_t i = begin; i != end; ++i) {
+            const Vector3 translation = Math::swizzle<'x', '0', 'y'>(Vector2(copies[i].position));
+            translations.push_back(translation);
+            hiddenSides.push_back(copies[i].hiddenSides);
+            partMin = Math::min(partMin, min + translation);
+            partMax = Math::max(partMax, max + translation);
+        }
+        part.bounds = {partMin, partMax};
+
+        for(UnsignedInt lod = 0; lod != lodCount; ++lod) {
+            Lod& l = part.lods[lod];
+            if(indexType == Mesh::IndexType::UnsignedInt)
+                merge<UnsignedInt>(data[lod], sides[lod], translations.data(), hiddenSides.data(), translations.size(), l.vertices, l.indices, l.mesh, indexType);
+            else
+                merge<UnsignedShort>(data[lod], sides[lod], translations.data(), hiddenSides.data(), translations.size(), l.vertices, l.indices, l.mesh, indexType);
+        }
+
+        begin = end;
+    }
+}
+
+void StaticGeometry::draw(const Matrix4& transformationMatrix, SceneGraph::Camera3D& camera) {
+    Camera& gameCamera = static_cast<Camera&>(camera);
+    Rendering::RenderQueue& queue = Application::instance()->renderQueue();
+
+    /* Camera position relative to the geometry */
+    const Vector3 eye = transformationMatrix.inverted().translation();
+
+    drawTransformation = transformationMatrix;
+    for(std::size_t i = 0; i != parts.size(); ++i) {
+        Part& part = *parts[i];
+        if(!gameCamera.isVisible(transformationMatrix, part.bounds)) continue;
+
+        /* Distance to the nearest point of the chunk */
+        const Float distance = Math::max(Math::max(part.bounds.min() - eye, eye - part.bounds.max()), Vector3{}).length();
+        part.currentLod = Math::min(Camera::levelOfDetail(distance), part.lodCount - 1);
+
+        queue.addOpaque(*shader, part.lods[part.currentLod].mesh, Rendering::RenderQueue::material(color), *this, drawTransformation, distance, i);
+    }
+}
+
+UnsignedInt StaticGeometry::submit(UnsignedInt part, bool) {
+    /* All parts share the transformation, so it's uploaded only for the
+       first one */
+    const UnsignedInt uploadCount = shader->uploadCount();
+    shader->setTransformation(drawTransformation)
+          .setDiffuseColor(color);
+
+    parts[part]->lods[parts[part]->currentLod].mesh.draw(*shader);
+    return shader->uploadCount() - uploadCount;
+}
+
+}}
@@ -0,0 +1,113 @@
+#ifndef PushTheBox_Game_StaticGeometry_h
+#define PushTheBox_Game_StaticGeometry_h
+
+/** @file
+ * @brief Class PushTheBox::Game::StaticGeometry
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <Corrade/Containers/EnumSet.h>
+#include <Magnum/Buffer.h>
+#include <Magnum/Color.h>
+#include <Magnum/Mesh.h>
+#include <Magnum/ResourceManager.h>
+#include <Magnum/SceneGraph/Drawable.h>
+#include <Magnum/SceneGraph/DualQuaternionTransformation.h>
+
+#include "PushTheBox.h"
+#include "Rendering/RenderQueue.h"
+
+namespace PushTheBox {
+
+namespace Shaders {
+    class CachedPhong;
+}
+
+namespace Game {
+
+/**
+@brief Merged static level geometry
+
+All copies of one mesh with one material, pre-transformed into a single
+vertex and index buffer at level load. Tiles which never move are thus drawn
+with a few draw calls regardless of level size. The copies are grouped into
+8x8 cell chunks, each with its own bounding box, so chunks outside of the
+view frustum are culled. If 32-bit indices are not available, the chunks are
+further split into parts of at most 65536 vertices. If the mesh has
+simplified versions (named `<mesh>-lod1`, `<mesh>-lod2`), each chunk is built
+in all of them and the level of detail is picked from distance of the chunk
+to the camera. Sides of a copy which are flush with a neighbor copy can be
+hidden, triangles lying on them are then left out of the merged mesh.
+*/
+class StaticGeometry: public Object3D, SceneGraph::Drawable3D, Rendering::RenderQueue::Renderable {
+    public:
+        /**
+         * @brief Cell side
+         *
+         * Level Y axis goes along scene Z axis.
+         * @see @ref Sides
+         */
+        enum class Side: UnsignedByte {
+            NegativeX = 1 << 0, /**< Towards the previous column */
+            PositiveX = 1 << 1, /**< Towards the next column */
+            NegativeZ = 1 << 2, /**< Towards the previous row */
+            PositiveZ = 1 << 3  /**< Towards the next row */
+        };
+
+        /** @brief Cell sides */
+        typedef Containers::EnumSet<Side> Sides;
+
+        /**
+         * @brief Constructor
+         * @param mesh      Mesh resource name
+         * @param color     Diffuse color
+         * @param parent    Parent object
+         * @param drawables Drawable group
+         */
+        explicit StaticGeometry(const std::string& mesh, const Color3& color, Object3D* parent, SceneGraph::DrawableGroup3D* drawables);
+
+        ~StaticGeometry();
+
+        /**
+         * @brief Add copy of the mesh at given level position
+         * @param position      Level position
+         * @param hiddenSides   Sides which are covered by a neighbor and thus
+         *      never visible
+         */
+        void add(const Vector2i& position, Sides hiddenSides = {});
+
+        /**
+         * @brief Build the merged meshes
+         *
+         * Call after all copies are added.
+         */
+        void build();
+
+        /** @seemagnum{SceneGraph::Drawable::draw()} */
+        void draw(const Matrix4& transformationMatrix, SceneGraph::Camera3D& camera) override;
+
+    private:
+        struct Copy {
+            Vector2i position;
+            Sides hiddenSides;
+        };
+        struct Lod;
+        struct Part;
+
+        UnsignedInt submit(UnsignedInt part, bool materialChanged) override;
+
+        Resource<AbstractShaderProgram, Shaders::CachedPhong> shader;
+        std::string mesh;
+        Color3 color;
+        Matrix4 drawTransformation;
+        std::vector<Copy> copies;
+        std::vector<std::unique_ptr<Part>> parts;
+};
+
+CORRADE_ENUMSET_OPERATORS(StaticGeometry::Sides)
+
+}}
+
+#endif
@@ -0,0 +1,163 @@
+#include "Headless.h"
+
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+#include <Corrade/Utility/Assert.h>
+#include <Corrade/Utility/Debug.h>
+#include <Corrade/Utility/Directory.h>
+#include <Magnum/Image.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/RenderbufferFormat.h>
+#include <Magnum/Renderer.h>
+#include <Magnum/ResourceManager.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/ImageData.h>
+
+#include "configure.h"
+#include "Application.h"
+#include "Game/Camera.h"
+#include "Game/Game.h"
+
+namespace PushTheBox { namespace Headless {
+
+namespace {
+    /* Frames drawn before measuring, at least, while HUD animations are
+       running the warm-up continues */
+    constexpr UnsignedInt WarmupFrameCount = 10;
+
+    /* Frame count is rounded up to a multiple of this, so the captured
+       frames are exactly at the angles in their names */
+    constexpr UnsignedInt CaptureCount = 4;
+}
+
+Headless::Headless(const std::string& level, const Vector2i& size, const Int sampleCount, const UnsignedInt frameCount, const std::string& captureDirectory, const std::string& referenceDirectory, const Float tolerance): level(level), size(size), frameCount((Math::max(frameCount, CaptureCount) + CaptureCount - 1)/CaptureCount*CaptureCount), captureDirectory(captureDirectory), referenceDirectory(referenceDirectory), tolerance(tolerance), framebuffer({{}, size}), converterManager(MAGNUM_PLUGINS_IMAGECONVERTER_DIR), warmupFrame(0), frame(0), _failedCount(0), comparedCount(0) {
+    /* Offscreen framebuffer, multisampled one is resolved before capture */
+    if(sampleCount) {
+        color.setStorageMultisample(sampleCount, RenderbufferFormat::RGBA8, size);
+        depth.setStorageMultisample(sampleCount, RenderbufferFormat::DepthComponent24, size);
+
+        resolveColor.reset(new Renderbuffer);
+        resolveColor->setStorage(RenderbufferFormat::RGBA8, size);
+        resolveFramebuffer.reset(new Framebuffer({{}, size}));
+        resolveFramebuffer->attachRenderbuffer(Framebuffer::ColorAttachment(0), *resolveColor);
+        CORRADE_INTERNAL_ASSERT(resolveFramebuffer->checkStatus(FramebufferTarget::Draw) == Framebuffer::Status::Complete);
+    } else {
+        color.setStorage(RenderbufferFormat::RGBA8, size);
+        depth.setStorage(RenderbufferFormat::DepthComponent24, size);
+    }
+    framebuffer.attachRenderbuffer(Framebuffer::ColorAttachment(0), color)
+        .attachRenderbuffer(Framebuffer::BufferAttachment::Depth, depth);
+    CORRADE_INTERNAL_ASSERT(framebuffer.checkStatus(FramebufferTarget::Read) == Framebuffer::Status::Complete);
+    CORRADE_INTERNAL_ASSERT(framebuffer.checkStatus(FramebufferTarget::Draw) == Framebuffer::Status::Complete);
+
+    /* Image writer */
+    if(!captureDirectory.empty()) {
+        if(!(converterManager.load("TgaImageConverter") & PluginManager::LoadState::Loaded))
+            std::exit(1);
+        converter = converterManager.instance("TgaImageConverter");
+        Utility::Directory::mkpath(captureDirectory);
+    }
+
+    Game::Game& game = *Application::instance()->gameScreen();
+    game.camera().setFramebuffer(framebuffer);
+    game.loadLevel(level);
+    game.setPlayerRotation(Deg(0.0f));
+    game.synchronize();
+    game.resume();
+
+    frameStart = std::chrono::steady_clock::now();
+}
+
+Headless::~Headless() = default;
+
+bool Headless::nextFrame() {
+    Renderer::finish();
+    const std::chrono::steady_clock::time_point frameEnd = std::chrono::steady_clock::now();
+    Game::Game& game = *Application::instance()->gameScreen();
+
+    /* Warm up */
+    if(!frame && (warmupFrame < WarmupFrameCount || game.isAnimating())) {
+        ++warmupFrame;
+
+    /* Measure and capture the frame */
+    } else {
+        statistics.add(std::chrono::duration<Double, std::milli>(frameEnd - frameStart).count());
+        if(frame % (frameCount/CaptureCount) == 0 && frame/(frameCount/CaptureCount) < CaptureCount)
+            capture(frame/(frameCount/CaptureCount)*360/CaptureCount);
+
+        /* Done */
+        if(++frame == frameCount) {
+            Debug() << "Rendered" << frameCount << "frames of level" << level << "at" << size.x() << "x" << size.y() << "after" << warmupFrame << "warm-up frames";
+            Debug() << "Frame time average" << statistics.average() << "ms, p50" << statistics.percentile(50.0) << "ms, p95" << statistics.percentile(95.0) << "ms, p99" << statistics.percentile(99.0) << "ms, worst" << statistics.worst() << "ms";
+            if(comparedCount)
+                Debug() << comparedCount - _failedCount << "of" << comparedCount << "images match the references";
+            return false;
+        }
+
+        /* Captured images need to show exactly this rotation */
+        game.setPlayerRotation(Deg(360.0f*frame/frameCount));
+        game.synchronize();
+    }
+
+    frameStart = std::chrono::steady_clock::now();
+    return true;
+}
+
+void Headless::capture(const UnsignedInt angle) {
+    /* Resolve multisampled framebuffer first */
+    AbstractFramebuffer* source = &framebuffer;
+    if(resolveFramebuffer) {
+        AbstractFramebuffer::blit(framebuffer, *resolveFramebuffer, {{}, size}, FramebufferBlit::Color);
+        source = resolveFramebuffer.get();
+    }
+
+    Image2D image = source->read({{}, size}, Image2D{PixelFormat::RGBA, PixelType::UnsignedByte});
+
+    std::ostringstream out;
+    out << level << '-' << std::setw(3) << std::setfill('0') << angle << ".tga";
+    const std::string filename = out.str();
+
+    if(converter && !converter->exportToFile(image, Utility::Directory::join(captureDirectory, filename)))
+        Error() << "Cannot write captured image" << filename;
+    if(!referenceDirectory.empty()) compare(image, filename);
+}
+
+void Headless::compare(const Image2D& image, const std::string& filename) {
+    ++comparedCount;
+
+    Resource<Trade::AbstractImporter> importer = SceneResourceManager::instance().get<Trade::AbstractImporter>("tga-importer");
+    std::optional<Trade::ImageData2D> reference;
+    if(!importer->openFile(Utility::Directory::join(referenceDirectory, filename)) || !(reference = importer->image2D(0))) {
+        Error() << "Cannot open reference image" << filename;
+        ++_failedCount;
+        return;
+    }
+
+    if(reference->size() != image.size() || reference->format() != image.format() || reference->type() != image.type()) {
+        Error() << "Reference image" << filename << "has different size or format";
+        ++_failedCount;
+        return;
+    }
+
+    /* Both images have four bytes per pixel, so there's no row padding */
+    const auto* a = reinterpret_cast<const UnsignedByte*>(static_cast<const char*>(image.data()));
+    const auto* b = reinterpret_cast<const UnsignedByte*>(static_cast<const char*>(reference->data()));
+    const std::size_t byteCount = image.size().product()*4;
+    UnsignedLong sum = 0;
+    Int max = 0;
+    for(std::size_t i = 0; i != byteCount; ++i) {
+        const Int difference = Math::abs(Int(a[i]) - Int(b[i]));
+        sum += difference;
+        max = Math::max(max, difference);
+    }
+
+    const Float mean = Float(sum)/byteCount;
+    if(mean > tolerance) {
+        Error() << "Image" << filename << "differs from reference, mean difference" << mean << "and max" << max;
+        ++_failedCount;
+    } else Debug() << "Image" << filename << "matches reference, mean difference" << mean << "and max" << max;
+}
+
+}}
@@ -0,0 +1,105 @@
+#ifndef PushTheBox_Headless_Headless_h
+#define PushTheBox_Headless_Headless_h
+
+/** @file
+ * @brief Class PushTheBox::Headless::Headless
+ */
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <Corrade/PluginManager/Manager.h>
+#include <Magnum/Framebuffer.h>
+#include <Magnum/Renderbuffer.h>
+#include <Magnum/Trade/AbstractImageConverter.h>
+
+#include "PushTheBox.h"
+#include "Rendering/DurationStatistics.h"
+
+namespace PushTheBox { namespace Headless {
+
+/**
+@brief Headless rendering
+
+Renders a level into an offscreen framebuffer of fixed size, independently
+of the window, which is expected to be hidden. After a warm-up, during which
+shaders get compiled and HUD animations finish, the camera makes one orbit
+around the player over the measured frames. Each frame is waited for with
+@ref Renderer::finish(), so the frame times include the GPU work.
+
+Four frames of the orbit, at 0°, 90°, 180° and 270°, are optionally written
+as TGA images named `<level>-<angle>.tga` and compared against images of the
+same name in a reference directory. The orbit depends only on the frame
+index, so the images are reproducible as long as the rendering settings
+match.
+
+Without a display, the window can be created with Mesa llvmpipe through the
+SDL offscreen video driver, i.e. with `SDL_VIDEODRIVER=offscreen`.
+*/
+class Headless {
+    public:
+        /**
+         * @brief Constructor
+         * @param level                 Rendered level
+         * @param size                  Framebuffer size
+         * @param sampleCount           Multisample count, `0` for no
+         *      multisampling
+         * @param frameCount            Count of measured frames, rounded
+         *      up to a multiple of four
+         * @param captureDirectory      Directory to write captured images
+         *      to, empty for none
+         * @param referenceDirectory    Directory with reference images,
+         *      empty for no comparison
+         * @param tolerance             Largest allowed mean difference
+         *      from reference, in 8-bit color units
+         *
+         * Expects that the game screen is already created. Loads the level,
+         * points the game camera to the offscreen framebuffer and focuses
+         * the game screen.
+         */
+        explicit Headless(const std::string& level, const Vector2i& size, Int sampleCount, UnsignedInt frameCount, const std::string& captureDirectory, const std::string& referenceDirectory, Float tolerance);
+
+        ~Headless();
+
+        /**
+         * @brief Finish frame
+         * @return `false` if all frames are done, `true` otherwise
+         *
+         * Called after each drawn frame. Measures and optionally captures
+         * the frame and prepares the next one. When done, prints the frame
+         * time statistics and image comparison results.
+         */
+        bool nextFrame();
+
+        /**
+         * @brief Whether all captured images matched the references
+         *
+         * Always `true` if there are no references.
+         */
+        inline bool isPassed() const { return !_failedCount; }
+
+    private:
+        void capture(UnsignedInt angle);
+        void compare(const Image2D& image, const std::string& filename);
+
+        const std::string level;
+        const Vector2i size;
+        const UnsignedInt frameCount;
+        const std::string captureDirectory, referenceDirectory;
+        const Float tolerance;
+
+        Renderbuffer color, depth;
+        Framebuffer framebuffer;
+        std::unique_ptr<Renderbuffer> resolveColor;
+        std::unique_ptr<Framebuffer> resolveFramebuffer;
+        PluginManager::Manager<Trade::AbstractImageConverter> converterManager;
+        std::unique_ptr<Trade::AbstractImageConverter> converter;
+
+        Rendering::DurationStatistics statistics;
+        std::chrono::steady_clock::time_point frameStart;
+        UnsignedInt warmupFrame, frame, _failedCount, comparedCount;
+};
+
+}}
+
+#endif
@@ -1,5 +1,6 @@
 #include "Menu.h"
 
+#include <vector>
 #include <Magnum/DefaultFramebuffer.h>
 #include <Magnum/Renderer.h>
 #include <Magnum/SceneGraph/Camera2D.h>
@@ -9,9 +10,13 @@
 #include "Menu/Cursor.h"
 #include "Menu/MenuItem.h"
 
+#ifdef PUSHTHEBOX_WITH_EDITOR
+#include "Editor/Editor.h"
+#endif
+
 namespace PushTheBox { namespace Menu {
 
-Menu::Menu() {
+Menu::Menu(): text(Color4(1.0f), {0.55f, 0.45f}) {
     /* Configure camera */
     camera = new SceneGraph::Camera2D(scene);
     camera->setProjectionMatrix(Matrix3::projection({8.0f/3.0f, 2.0f}))
@@ -19,21 +24,29 @@ Menu::Menu() {
         .setViewport(defaultFramebuffer.viewport().size());
 
     /* Add menu items */
+    std::vector<MenuItem*> items;
     MenuItem* i;
-    i = new MenuItem("resume", &scene, &drawables, &shapes);
-    i->translate(Vector2::yAxis(0.3f));
+    items.push_back(i = new MenuItem("resume", &scene, &drawables, &shapes, text));
     Interconnect::connect(*i, &MenuItem::clicked, *Game::Game::instance(), &Game::Game::resume);
 
-    i = new MenuItem("restart level", &scene, &drawables, &shapes);
+    items.push_back(i = new MenuItem("restart level", &scene, &drawables, &shapes, text));
     Interconnect::connect(*i, &MenuItem::clicked, *Game::Game::instance(), &Game::Game::restartLevel);
 
-    i = new MenuItem("exit", &scene, &drawables, &shapes);
-    i->translate(Vector2::yAxis(-0.3f));
+    #ifdef PUSHTHEBOX_WITH_EDITOR
+    items.push_back(i = new MenuItem("level editor", &scene, &drawables, &shapes, text));
+    Interconnect::connect(*i, &MenuItem::clicked, *Application::instance()->editorScreen(), &Editor::Editor::open);
+    #endif
+
+    items.push_back(i = new MenuItem("exit", &scene, &drawables, &shapes, text));
     /** @todo What about this? */
     #ifndef CORRADE_TARGET_NACL
     Interconnect::connect(*i, &MenuItem::clicked, *Application::instance(), &Application::exit);
     #endif
 
+    /* Center the items vertically, the editor item is not everywhere */
+    for(std::size_t index = 0; index != items.size(); ++index)
+        items[index]->translate(Vector2::yAxis(0.3f*((items.size() - 1)*0.5f - index)));
+
     /* Add cursor */
     cursor = new Cursor(&scene, &shapes);
     cursor->translate({-10.0f, -10.0f});
@@ -52,12 +65,15 @@ void Menu::viewportEvent(const Vector2i& size) {
 }
 
 void Menu::drawEvent() {
+    Rendering::GpuProfiler::Scope scope(Application::instance()->gpuProfiler(), "menu");
     Renderer::enable(Renderer::Feature::Blending);
     Renderer::setBlendFunction(Renderer::BlendFunction::One, Renderer::BlendFunction::OneMinusSourceAlpha);
     Renderer::disable(Renderer::Feature::DepthTest);
     /** @todo fix this in magnum, so it doesn't have to be called? */
     shapes.setClean();
     camera->draw(drawables);
+    text.draw(camera->projectionMatrix());
+    Application::instance()->renderQueue().flush();
     Renderer::enable(Renderer::Feature::DepthTest);
     Renderer::disable(Renderer::Feature::Blending);
 }
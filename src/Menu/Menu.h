@@ -14,6 +14,7 @@
 #include <Magnum/SceneGraph/Scene.h>
 
 #include "PushTheBox.h"
+#include "Rendering/TextBatch.h"
 
 namespace PushTheBox { namespace Menu {
 
@@ -33,6 +34,7 @@ class Menu: public Platform::Screen, public Interconnect::Receiver {
         void mouseMoveEvent(MouseMoveEvent& event) override;
 
     private:
+        Rendering::TextBatch text;
         Scene2D scene;
         SceneGraph::DrawableGroup2D drawables;
         Shapes::ShapeGroup2D shapes;
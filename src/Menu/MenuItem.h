@@ -6,19 +6,20 @@
  */
 
 #include <Corrade/Interconnect/Emitter.h>
-#include <Magnum/Buffer.h>
-#include <Magnum/Color.h>
-#include <Magnum/Mesh.h>
-#include <Magnum/Resource.h>
 #include <Magnum/SceneGraph/Drawable.h>
 #include <Magnum/SceneGraph/TranslationTransformation.h>
-#include <Magnum/Shaders/Shaders.h>
 #include <Magnum/Shapes/AxisAlignedBox.h>
 #include <Magnum/Shapes/Shape.h>
 
 #include "PushTheBox.h"
 
-namespace PushTheBox { namespace Menu {
+namespace PushTheBox {
+
+namespace Rendering {
+    class TextBatch;
+}
+
+namespace Menu {
 
 /** @brief %Menu item */
 class MenuItem: public Object2D, SceneGraph::Drawable2D, public Shapes::Shape<Shapes::AxisAlignedBox2D>, public Interconnect::Emitter {
@@ -29,8 +30,9 @@ class MenuItem: public Object2D, SceneGraph::Drawable2D, public Shapes::Shape<Sh
          * @param parent        Parent object
          * @param drawables     Drawable group
          * @param shapes        Shape group
+         * @param batch         Text batch to put the title into
          */
-        MenuItem(const std::string& title, Object2D* parent, SceneGraph::DrawableGroup2D* drawableGroup, Shapes::ShapeGroup2D* shapes);
+        MenuItem(const std::string& title, Object2D* parent, SceneGraph::DrawableGroup2D* drawableGroup, Shapes::ShapeGroup2D* shapes, Rendering::TextBatch& batch);
 
         void hoverChanged(bool hovered);
 
@@ -42,11 +44,8 @@ class MenuItem: public Object2D, SceneGraph::Drawable2D, public Shapes::Shape<Sh
         void draw(const Matrix3& transformationMatrix, SceneGraph::Camera2D& camera) override;
 
     private:
-        Resource<AbstractShaderProgram, Shaders::DistanceFieldVector2D> shader;
-        Resource<Text::GlyphCache> glyphCache;
-        Buffer vertexBuffer, indexBuffer;
-        Mesh mesh;
-        Color3 color;
+        Rendering::TextBatch& batch;
+        const UnsignedInt id;
 };
 
 }}
@@ -0,0 +1,114 @@
+#include "CpuProfiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace PushTheBox { namespace Rendering {
+
+namespace {
+    /* Should be enough for a few minutes of gameplay */
+    constexpr std::size_t BufferCapacity = 65536;
+
+    struct Event {
+        const char* name;
+        std::chrono::steady_clock::time_point begin, end;
+    };
+
+    /* Only the owning thread writes the events, the count is published after
+       the event is written so the reader never sees a half-written one */
+    struct Buffer {
+        explicit Buffer(std::size_t threadId): threadId(threadId), events(new Event[BufferCapacity]), count(0) {}
+
+        const std::size_t threadId;
+        std::unique_ptr<Event[]> events;
+        std::atomic<std::size_t> count;
+    };
+
+    /* Buffers are never freed, so the events of finished threads can be
+       still written out */
+    struct Registry {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<Buffer>> buffers;
+    };
+
+    Registry& registry() {
+        static Registry registry;
+        return registry;
+    }
+
+    Buffer& threadBuffer() {
+        thread_local Buffer* buffer = nullptr;
+        if(!buffer) {
+            Registry& r = registry();
+            std::lock_guard<std::mutex> lock{r.mutex};
+            r.buffers.emplace_back(new Buffer{r.buffers.size()});
+            buffer = r.buffers.back().get();
+        }
+
+        return *buffer;
+    }
+
+    Double microseconds(std::chrono::steady_clock::duration duration) {
+        return std::chrono::duration<Double, std::micro>(duration).count();
+    }
+}
+
+void CpuProfiler::record(const char* name, std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end) {
+    Buffer& buffer = threadBuffer();
+    const std::size_t count = buffer.count.load(std::memory_order_relaxed);
+    if(count == BufferCapacity) return;
+
+    buffer.events[count] = {name, begin, end};
+    buffer.count.store(count + 1, std::memory_order_release);
+}
+
+bool CpuProfiler::writeTrace(const std::string& filename) {
+    std::ofstream out(filename);
+    if(!out.good()) return false;
+
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock{r.mutex};
+
+    /* Take only events recorded until now, times are relative to the
+       earliest one */
+    std::vector<std::size_t> counts;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::time_point::max();
+    for(const std::unique_ptr<Buffer>& buffer: r.buffers) {
+        counts.push_back(buffer->count.load(std::memory_order_acquire));
+        for(std::size_t i = 0; i != counts.back(); ++i)
+            start = std::min(start, buffer->events[i].begin);
+    }
+
+    /* Microseconds with fractional part, the default precision would round
+       them after a few seconds already */
+    out << std::fixed;
+    out.precision(3);
+
+    out << "{\"traceEvents\":[";
+    for(std::size_t b = 0; b != r.buffers.size(); ++b) {
+        const Buffer& buffer = *r.buffers[b];
+
+        /* Name the threads, the first one to record is the main thread */
+        out << (b ? ",\n" : "\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << buffer.threadId
+            << ",\"args\":{\"name\":\"";
+        if(buffer.threadId) out << "worker " << buffer.threadId;
+        else out << "main";
+        out << "\"}}";
+
+        for(std::size_t i = 0; i != counts[b]; ++i) {
+            const Event& event = buffer.events[i];
+            out << ",\n{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << buffer.threadId
+                << ",\"ts\":" << microseconds(event.begin - start)
+                << ",\"dur\":" << microseconds(event.end - event.begin) << "}";
+        }
+    }
+    out << "\n]}\n";
+
+    return out.good();
+}
+
+}}
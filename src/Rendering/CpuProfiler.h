@@ -0,0 +1,82 @@
+#ifndef PushTheBox_Rendering_CpuProfiler_h
+#define PushTheBox_Rendering_CpuProfiler_h
+
+/** @file
+ * @brief Class PushTheBox::Rendering::CpuProfiler, macro PUSHTHEBOX_PROFILE_SCOPE()
+ */
+
+#include "configure.h"
+
+#ifdef PUSHTHEBOX_WITH_PROFILING
+#include <chrono>
+#include <string>
+
+#include "PushTheBox.h"
+
+namespace PushTheBox { namespace Rendering {
+
+/**
+@brief CPU profiler
+
+Records begin and end time of named scopes. Each thread records into its own
+fixed-size buffer without any locking, only the first use in a thread
+registers the buffer. When the buffer is full, further scopes in that thread
+are dropped. The recorded scopes can be written as Chrome `trace_event` JSON
+and viewed in `chrome://tracing`.
+
+Available only if the game is built with `WITH_PROFILING` enabled, use
+@ref PUSHTHEBOX_PROFILE_SCOPE() instead of using this class directly, so the
+profiling compiles out completely otherwise.
+*/
+class CpuProfiler {
+    public:
+        /** @brief Profiled scope */
+        class Scope {
+            public:
+                /**
+                 * @brief Constructor
+                 *
+                 * The name is not copied, it has to be a string literal.
+                 */
+                explicit Scope(const char* name): name(name), begin(std::chrono::steady_clock::now()) {}
+
+                ~Scope() { record(name, begin, std::chrono::steady_clock::now()); }
+
+            private:
+                const char* name;
+                std::chrono::steady_clock::time_point begin;
+        };
+
+        CpuProfiler() = delete;
+
+        /**
+         * @brief Write recorded scopes of all threads to a file
+         *
+         * Should be called when no other thread is recording anymore, scopes
+         * recorded during the call might be left out. Returns `false` if the
+         * file can't be written.
+         */
+        static bool writeTrace(const std::string& filename);
+
+    private:
+        static void record(const char* name, std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end);
+};
+
+}}
+
+#define _PUSHTHEBOX_PROFILE_SCOPE_NAME(line) _pushTheBoxProfileScope##line
+#define _PUSHTHEBOX_PROFILE_SCOPE(name, line) \
+    PushTheBox::Rendering::CpuProfiler::Scope _PUSHTHEBOX_PROFILE_SCOPE_NAME(line){name}
+
+/**
+@brief Profile the rest of current scope
+
+The name has to be a string literal. Expands to nothing if the game is not
+built with `WITH_PROFILING` enabled.
+*/
+#define PUSHTHEBOX_PROFILE_SCOPE(name) _PUSHTHEBOX_PROFILE_SCOPE(name, __LINE__)
+#else
+#define PUSHTHEBOX_PROFILE_SCOPE(name)
+#endif
+
+#endif
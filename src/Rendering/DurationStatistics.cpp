@@ -0,0 +1,32 @@
+#include "DurationStatistics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <Magnum/Math/Functions.h>
+
+namespace PushTheBox { namespace Rendering {
+
+Double DurationStatistics::average() const {
+    if(samples.empty()) return 0.0;
+    return std::accumulate(samples.begin(), samples.end(), 0.0)/samples.size();
+}
+
+Double DurationStatistics::percentile(const Double percent) const {
+    if(samples.empty()) return 0.0;
+
+    /* Smallest sample with at least given percentage of samples not larger
+       than it */
+    const std::size_t rank = std::size_t(std::ceil(Math::clamp(percent, 0.0, 100.0)/100.0*samples.size()));
+    std::vector<Double> sorted = samples;
+    const auto nth = sorted.begin() + (rank ? rank - 1 : 0);
+    std::nth_element(sorted.begin(), nth, sorted.end());
+    return *nth;
+}
+
+Double DurationStatistics::worst() const {
+    if(samples.empty()) return 0.0;
+    return *std::max_element(samples.begin(), samples.end());
+}
+
+}}
@@ -0,0 +1,53 @@
+#ifndef PushTheBox_Rendering_DurationStatistics_h
+#define PushTheBox_Rendering_DurationStatistics_h
+
+/** @file
+ * @brief Class PushTheBox::Rendering::DurationStatistics
+ */
+
+#include <vector>
+#include <Magnum/Magnum.h>
+
+#include "PushTheBox.h"
+
+namespace PushTheBox { namespace Rendering {
+
+/**
+@brief Duration statistics
+
+Collects durations such as frame times and reports their average and
+percentiles. All samples are kept, so the percentiles are exact.
+*/
+class DurationStatistics {
+    public:
+        /** @brief Add a sample */
+        inline void add(Double duration) { samples.push_back(duration); }
+
+        /** @brief Remove all samples */
+        inline void clear() { samples.clear(); }
+
+        /** @brief Sample count */
+        inline std::size_t count() const { return samples.size(); }
+
+        /** @brief Average, `0.0` if there are no samples */
+        Double average() const;
+
+        /**
+         * @brief Percentile
+         * @param percent   Percentage of samples which are not larger than
+         *      the result, from `0.0` to `100.0`
+         *
+         * Nearest-rank percentile, `0.0` if there are no samples.
+         */
+        Double percentile(Double percent) const;
+
+        /** @brief Largest sample, `0.0` if there are no samples */
+        Double worst() const;
+
+    private:
+        std::vector<Double> samples;
+};
+
+}}
+
+#endif
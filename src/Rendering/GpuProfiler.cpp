@@ -0,0 +1,143 @@
+#include "GpuProfiler.h"
+
+#include <Corrade/Utility/Assert.h>
+#include <Corrade/Utility/Debug.h>
+#include <Magnum/Context.h>
+#include <Magnum/Extensions.h>
+#ifndef MAGNUM_TARGET_WEBGL
+#include <Magnum/TimeQuery.h>
+#endif
+#if defined(MAGNUM_TARGET_GLES) && !defined(MAGNUM_TARGET_WEBGL)
+#include <Magnum/OpenGL.h>
+#endif
+
+namespace PushTheBox { namespace Rendering {
+
+struct GpuProfiler::Frame {
+    #ifndef MAGNUM_TARGET_WEBGL
+    /* Queries are reused, only the first `used` are issued this frame */
+    std::vector<TimeQuery> queries;
+    #endif
+    std::vector<std::size_t> passIds;
+    std::size_t used{};
+};
+
+bool GpuProfiler::isSupported() {
+    #ifndef MAGNUM_TARGET_GLES
+    return Context::current().isExtensionSupported<Extensions::GL::ARB::timer_query>();
+    #elif !defined(MAGNUM_TARGET_WEBGL)
+    return Context::current().isExtensionSupported<Extensions::GL::EXT::disjoint_timer_query>();
+    #else
+    return false;
+    #endif
+}
+
+GpuProfiler::GpuProfiler(UnsignedInt averageFrameCount): averageFrameCount(averageFrameCount), averagedFrames(0), currentFrame(0), _enabled(false), active(false), frames(new Frame[Latency]) {}
+
+GpuProfiler::~GpuProfiler() = default;
+
+void GpuProfiler::setEnabled(bool enabled) {
+    _enabled = enabled && isSupported();
+    if(!_enabled) {
+        for(UnsignedInt i = 0; i != Latency; ++i) frames[i].used = 0;
+        _passes.clear();
+        sums.clear();
+        counts.clear();
+        averagedFrames = 0;
+    }
+}
+
+void GpuProfiler::begin(const char* name) {
+    if(!_enabled) return;
+    CORRADE_ASSERT(!active, "Rendering::GpuProfiler::begin(): passes can't be nested", );
+
+    /* Find the pass or add a new one */
+    std::size_t id = 0;
+    while(id != _passes.size() && _passes[id].name != name) ++id;
+    if(id == _passes.size()) {
+        _passes.push_back({name, 0.0});
+        sums.push_back(0.0);
+        counts.push_back(0);
+    }
+
+    #ifndef MAGNUM_TARGET_WEBGL
+    Frame& frame = frames[currentFrame];
+    if(frame.used == frame.queries.size()) {
+        frame.queries.emplace_back(TimeQuery::Target::TimeElapsed);
+        frame.passIds.push_back(id);
+    }
+    frame.passIds[frame.used] = id;
+    frame.queries[frame.used].begin();
+    #endif
+
+    active = true;
+}
+
+void GpuProfiler::end() {
+    if(!_enabled) return;
+    CORRADE_ASSERT(active, "Rendering::GpuProfiler::end(): no pass active", );
+
+    #ifndef MAGNUM_TARGET_WEBGL
+    Frame& frame = frames[currentFrame];
+    frame.queries[frame.used++].end();
+    #endif
+
+    active = false;
+}
+
+void GpuProfiler::nextFrame() {
+    if(!_enabled) return;
+    CORRADE_ASSERT(!active, "Rendering::GpuProfiler::nextFrame(): pass not ended", );
+
+    /* Collect the oldest frame in the ring, it'll be reused for the next
+       one. Results which are not ready yet are dropped instead of waiting
+       for them. */
+    currentFrame = (currentFrame + 1) % Latency;
+    Frame& frame = frames[currentFrame];
+
+    /* On ES a disjoint operation such as a GPU frequency change makes the
+       results of queries in flight meaningless, reading the flag resets it */
+    #if defined(MAGNUM_TARGET_GLES) && !defined(MAGNUM_TARGET_WEBGL)
+    GLint disjoint = 0;
+    glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+    if(disjoint) frame.used = 0;
+    #endif
+
+    #ifndef MAGNUM_TARGET_WEBGL
+    for(std::size_t i = 0; i != frame.used; ++i) {
+        if(!frame.queries[i].resultAvailable()) continue;
+        sums[frame.passIds[i]] += frame.queries[i].result<UnsignedLong>()/1.0e6;
+        ++counts[frame.passIds[i]];
+    }
+    #endif
+    const bool collected = frame.used;
+    frame.used = 0;
+
+    /* Compute the averages from the results which were actually available,
+       passes without any keep their previous time */
+    if(!collected || ++averagedFrames != averageFrameCount) return;
+    for(std::size_t i = 0; i != _passes.size(); ++i) {
+        if(counts[i]) _passes[i].time = sums[i]/counts[i];
+        sums[i] = 0.0;
+        counts[i] = 0;
+    }
+    averagedFrames = 0;
+    updated();
+}
+
+void GpuProfiler::print() const {
+    if(!_enabled) {
+        Debug() << "GPU profiler is not enabled or timer queries are not supported";
+        return;
+    }
+
+    Debug() << "GPU time averaged over" << averageFrameCount << "frames:";
+    Double total = 0.0;
+    for(const Pass& pass: _passes) {
+        Debug() << "   " << pass.name << pass.time << "ms";
+        total += pass.time;
+    }
+    Debug() << "    total" << total << "ms";
+}
+
+}}
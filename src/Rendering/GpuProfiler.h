@@ -0,0 +1,125 @@
+#ifndef PushTheBox_Rendering_GpuProfiler_h
+#define PushTheBox_Rendering_GpuProfiler_h
+
+/** @file
+ * @brief Class PushTheBox::Rendering::GpuProfiler
+ */
+
+#include <memory>
+#include <vector>
+#include <Corrade/Interconnect/Emitter.h>
+#include <Magnum/Magnum.h>
+
+#include "PushTheBox.h"
+
+namespace PushTheBox { namespace Rendering {
+
+/**
+@brief GPU profiler
+
+Measures GPU time of named passes with timer queries. Results of a frame are
+read only a few frames later from a ring of query objects, so the CPU never
+waits for the GPU; results which are not available even then are dropped.
+The times are averaged over a configurable count of frames, counting only
+the results which were available. On OpenGL ES, frames during which the GPU
+reported a disjoint operation are dropped as well.
+
+The passes must not be nested. If timer queries are not supported or the
+profiler is not enabled, @ref begin() and @ref end() do nothing.
+*/
+class GpuProfiler: public Interconnect::Emitter {
+    public:
+        /**
+         * @brief Profiled pass
+         *
+         * Calls @ref begin() in constructor and @ref end() in destructor.
+         */
+        class Scope {
+            public:
+                explicit Scope(GpuProfiler& profiler, const char* name): profiler(profiler) {
+                    profiler.begin(name);
+                }
+
+                ~Scope() { profiler.end(); }
+
+            private:
+                GpuProfiler& profiler;
+        };
+
+        /** @brief Pass statistics */
+        struct Pass {
+            const char* name;   /**< Pass name */
+            Double time;        /**< Average time in milliseconds */
+        };
+
+        /** @brief Whether timer queries are supported */
+        static bool isSupported();
+
+        /**
+         * @brief Constructor
+         * @param averageFrameCount     Count of frames to average the times
+         *      over
+         *
+         * Doesn't need a GL context, the queries are created on first use.
+         */
+        explicit GpuProfiler(UnsignedInt averageFrameCount = 30);
+
+        ~GpuProfiler();
+
+        /** @brief Whether the profiler is enabled */
+        inline bool isEnabled() const { return _enabled; }
+
+        /**
+         * @brief Enable or disable the profiler
+         *
+         * Has no effect if timer queries are not supported. Disabled by
+         * default.
+         */
+        void setEnabled(bool enabled);
+
+        /**
+         * @brief Begin pass
+         *
+         * The name is compared by pointer, pass a string literal.
+         */
+        void begin(const char* name);
+
+        /** @brief End pass */
+        void end();
+
+        /**
+         * @brief Start next frame
+         *
+         * Called after buffer swap, collects results of a frame old enough
+         * and emits @ref updated() if new averages are available.
+         */
+        void nextFrame();
+
+        /** @brief Averaged pass times, in order of first appearance */
+        inline const std::vector<Pass>& passes() const { return _passes; }
+
+        /** @brief Print averaged pass times */
+        void print() const;
+
+        /** @brief New averages are available in @ref passes() */
+        inline Signal updated() {
+            return emit<GpuProfiler>(&GpuProfiler::updated);
+        }
+
+    private:
+        struct Frame;
+
+        /* Frames between issuing the query and reading the result */
+        enum: UnsignedInt { Latency = 4 };
+
+        UnsignedInt averageFrameCount, averagedFrames, currentFrame;
+        bool _enabled, active;
+        std::unique_ptr<Frame[]> frames;
+        std::vector<Pass> _passes;
+        std::vector<Double> sums;
+        std::vector<UnsignedInt> counts;
+};
+
+}}
+
+#endif
@@ -0,0 +1,57 @@
+#include "InputLatency.h"
+
+#include <cmath>
+#include <Corrade/Utility/Debug.h>
+#include <Magnum/Math/Functions.h>
+
+namespace PushTheBox { namespace Rendering {
+
+constexpr Double InputLatency::BucketSize;
+
+InputLatency::InputLatency(UnsignedInt updateSampleCount): updateSampleCount(updateSampleCount), _count(0), pending(false), _worst(0.0), buckets{} {}
+
+void InputLatency::input(const std::chrono::steady_clock::time_point time) {
+    if(pending) return;
+
+    pending = true;
+    pendingTime = time;
+}
+
+void InputLatency::present() {
+    if(!pending) return;
+    pending = false;
+
+    const Double latency = std::chrono::duration<Double, std::milli>(std::chrono::steady_clock::now() - pendingTime).count();
+    ++buckets[Math::min(UnsignedInt(latency/BucketSize), UnsignedInt(BucketCount - 1))];
+    _worst = Math::max(_worst, latency);
+
+    if(++_count % updateSampleCount == 0) updated();
+}
+
+Double InputLatency::percentile(const Double percent) const {
+    if(!_count) return 0.0;
+
+    /* Smallest bucket with at least given percentage of samples in it or
+       below, the last one is unbounded */
+    const UnsignedInt rank = Math::max(UnsignedInt(std::ceil(Math::clamp(percent, 0.0, 100.0)/100.0*_count)), 1u);
+    UnsignedInt sum = 0;
+    for(UnsignedInt i = 0; i != BucketCount - 1; ++i)
+        if((sum += buckets[i]) >= rank) return Math::min((i + 1)*BucketSize, _worst);
+
+    return _worst;
+}
+
+void InputLatency::print() const {
+    if(!_count) {
+        Debug() << "No input latency samples";
+        return;
+    }
+
+    Debug() << "Input to swap latency of" << _count << "frames:";
+    Debug() << "    p50" << percentile(50.0) << "ms";
+    Debug() << "    p95" << percentile(95.0) << "ms";
+    Debug() << "    p99" << percentile(99.0) << "ms";
+    Debug() << "    worst" << _worst << "ms";
+}
+
+}}
@@ -0,0 +1,93 @@
+#ifndef PushTheBox_Rendering_InputLatency_h
+#define PushTheBox_Rendering_InputLatency_h
+
+/** @file
+ * @brief Class PushTheBox::Rendering::InputLatency
+ */
+
+#include <chrono>
+#include <Corrade/Interconnect/Emitter.h>
+#include <Magnum/Magnum.h>
+
+#include "PushTheBox.h"
+
+namespace PushTheBox { namespace Rendering {
+
+/**
+@brief Input latency histogram
+
+Measures time from an accepted input to the buffer swap which first shows
+its effect. If more inputs arrive before the swap, only the earliest one is
+measured, so there is at most one sample per frame. The swap is blocking
+with vertical sync enabled, so the time after it is close to the moment the
+frame gets on screen.
+
+The samples are collected in a histogram with fixed buckets, so the memory
+doesn't grow with playing time. The percentiles are rounded up to the bucket
+size.
+*/
+class InputLatency: public Interconnect::Emitter {
+    public:
+        /** @brief Histogram bucket size in milliseconds */
+        static constexpr Double BucketSize = 0.25;
+
+        /** @brief Histogram bucket count, larger latencies go to the last */
+        enum: UnsignedInt { BucketCount = 800 };
+
+        /**
+         * @brief Constructor
+         * @param updateSampleCount     Count of samples after which
+         *      @ref updated() is emitted
+         */
+        explicit InputLatency(UnsignedInt updateSampleCount = 10);
+
+        /**
+         * @brief Record accepted input
+         * @param time      Time when the input arrived
+         *
+         * Take the time before processing the input, so the processing is
+         * included in the latency.
+         */
+        void input(std::chrono::steady_clock::time_point time);
+
+        /**
+         * @brief Buffers were swapped
+         *
+         * Called right after buffer swap, adds a sample if there was any
+         * input since the previous swap.
+         */
+        void present();
+
+        /** @brief Sample count */
+        inline UnsignedInt count() const { return _count; }
+
+        /**
+         * @brief Latency percentile in milliseconds
+         *
+         * Upper bound of the bucket containing given percentile, `0.0` if
+         * there are no samples.
+         */
+        Double percentile(Double percent) const;
+
+        /** @brief Largest latency in milliseconds */
+        inline Double worst() const { return _worst; }
+
+        /** @brief Print latency percentiles */
+        void print() const;
+
+        /** @brief New samples were added since last emit */
+        inline Signal updated() {
+            return emit<InputLatency>(&InputLatency::updated);
+        }
+
+    private:
+        UnsignedInt updateSampleCount, _count;
+        bool pending;
+        std::chrono::steady_clock::time_point pendingTime;
+        Double _worst;
+        UnsignedInt buckets[BucketCount];
+};
+
+}}
+
+#endif
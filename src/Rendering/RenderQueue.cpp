@@ -0,0 +1,141 @@
+#include "RenderQueue.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <Magnum/Mesh.h>
+#include <Magnum/Renderer.h>
+#include <Magnum/Math/Functions.h>
+
+#include "Shaders/Unshaded.h"
+
+namespace PushTheBox { namespace Rendering {
+
+namespace {
+
+/* Key layout: 16 bits shader, 24 bits mesh, 24 bits material. Shaders and
+   meshes are identified by hashed address, collisions only make the sorting
+   less efficient, state change tracking compares the actual pointers. */
+inline UnsignedLong hash(const void* pointer, UnsignedInt bits) {
+    return (std::uintptr_t(pointer) >> 4) & ((UnsignedLong(1) << bits) - 1);
+}
+
+}
+
+RenderQueue::Renderable::~Renderable() = default;
+
+UnsignedInt RenderQueue::material(const Color3& color) {
+    const Math::Vector3<UnsignedByte> rgb = Math::denormalize<Math::Vector3<UnsignedByte>>(Math::clamp(color, 0.0f, 1.0f));
+    return (rgb.r() << 16)|(rgb.g() << 8)|rgb.b();
+}
+
+RenderQueue::RenderQueue(): _statistics{}, current{}, _sortOrder(SortOrder::State), _depthPrepass(false), _overdrawVisualization(false) {}
+
+RenderQueue::~RenderQueue() = default;
+
+void RenderQueue::add(AbstractShaderProgram& shader, Mesh& mesh, UnsignedInt material, Renderable& renderable, UnsignedInt part) {
+    const UnsignedLong key = (hash(&shader, 16) << 48)|(hash(&mesh, 24) << 24)|(material & 0xffffff);
+    packets.push_back({key, &shader, &mesh, &renderable, part, nullptr, 0.0f});
+}
+
+void RenderQueue::addOpaque(AbstractShaderProgram& shader, Mesh& mesh, UnsignedInt material, Renderable& renderable, const Matrix4& transformation, Float distance, UnsignedInt part) {
+    add(shader, mesh, material, renderable, part);
+    packets.back().transformation = &transformation;
+    packets.back().distance = distance;
+}
+
+void RenderQueue::flush() {
+    std::sort(packets.begin(), packets.end(), [](const Packet& a, const Packet& b) {
+        return a.key < b.key;
+    });
+    submit();
+}
+
+void RenderQueue::flush(const Matrix4& projectionMatrix) {
+    /* Nearest first, non-opaque packets last */
+    if(_depthPrepass || _sortOrder == SortOrder::FrontToBack)
+        std::stable_sort(packets.begin(), packets.end(), [](const Packet& a, const Packet& b) {
+            if(!a.transformation || !b.transformation) return a.transformation && !b.transformation;
+            return a.distance < b.distance;
+        });
+
+    /* Fill the depth buffer without shading anything */
+    if(_depthPrepass) {
+        Renderer::setColorMask(false, false, false, false);
+        drawUnshaded(projectionMatrix, {});
+        Renderer::setColorMask(true, true, true, true);
+        Renderer::setDepthFunction(Renderer::DepthFunction::LessOrEqual);
+    }
+
+    /* Count shaded fragments instead of shading them. The opaque packets are
+       drawn in the selected order to show its effect, without the pre-pass
+       sorted by state if the state order is selected. */
+    if(_overdrawVisualization) {
+        if(!_depthPrepass && _sortOrder == SortOrder::State)
+            std::sort(packets.begin(), packets.end(), [](const Packet& a, const Packet& b) {
+                if(!a.transformation || !b.transformation) return a.transformation && !b.transformation;
+                return a.key < b.key;
+            });
+        Renderer::enable(Renderer::Feature::Blending);
+        Renderer::setBlendFunction(Renderer::BlendFunction::One, Renderer::BlendFunction::One);
+        drawUnshaded(projectionMatrix, {0.125f, 0.0625f, 0.0f, 1.0f});
+        Renderer::disable(Renderer::Feature::Blending);
+        packets.clear();
+
+    /* Opaque packets are already sorted front to back, keep them in that
+       order and sort the rest by state */
+    } else if(_sortOrder == SortOrder::FrontToBack) {
+        std::sort(std::find_if(packets.begin(), packets.end(), [](const Packet& packet) {
+            return !packet.transformation;
+        }), packets.end(), [](const Packet& a, const Packet& b) {
+            return a.key < b.key;
+        });
+        submit();
+
+    } else flush();
+
+    if(_depthPrepass) Renderer::setDepthFunction(Renderer::DepthFunction::Less);
+}
+
+void RenderQueue::drawUnshaded(const Matrix4& projectionMatrix, const Color4& color) {
+    if(!unshadedShader) unshadedShader.reset(new Shaders::Unshaded);
+    unshadedShader->setProjectionMatrix(projectionMatrix)
+        .setColor(color);
+
+    for(const Packet& packet: packets) {
+        if(!packet.transformation) break;
+
+        unshadedShader->setTransformationMatrix(*packet.transformation);
+        packet.mesh->draw(*unshadedShader);
+        ++current.unshadedDraws;
+    }
+}
+
+void RenderQueue::submit() {
+    /* State set outside of the queue is unknown, so the first packet
+       always uploads everything */
+    AbstractShaderProgram* shader = nullptr;
+    Mesh* mesh = nullptr;
+    UnsignedInt material = ~UnsignedInt{};
+    for(const Packet& packet: packets) {
+        const UnsignedInt packetMaterial = packet.key & 0xffffff;
+        const bool materialChanged = packet.shader != shader || packetMaterial != material;
+
+        if(packet.shader != shader) ++current.shaderBinds;
+        if(packet.mesh != mesh) ++current.meshBinds;
+        current.uniformUploads += packet.renderable->submit(packet.part, materialChanged);
+        ++current.draws;
+
+        shader = packet.shader;
+        mesh = packet.mesh;
+        material = packetMaterial;
+    }
+
+    packets.clear();
+}
+
+void RenderQueue::nextFrame() {
+    _statistics = current;
+    current = {};
+}
+
+}}
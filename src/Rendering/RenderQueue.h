@@ -0,0 +1,221 @@
+#ifndef PushTheBox_Rendering_RenderQueue_h
+#define PushTheBox_Rendering_RenderQueue_h
+
+/** @file
+ * @brief Class PushTheBox::Rendering::RenderQueue
+ */
+
+#include <memory>
+#include <vector>
+#include <Magnum/Color.h>
+#include <Magnum/Math/Matrix4.h>
+
+#include "PushTheBox.h"
+
+namespace PushTheBox {
+
+namespace Shaders {
+    class Unshaded;
+}
+
+namespace Rendering {
+
+/**
+@brief Sorted render queue
+
+Drawables don't draw directly in their `draw()` function, but add one draw
+packet per mesh to the queue. The packets are sorted by a 64-bit key composed
+of shader, mesh and material and submitted in that order on @ref flush(), so
+consecutive draws share as much GL state as possible and material uniforms
+are uploaded only when the material actually changes.
+
+Opaque packets added with @ref addOpaque() can be alternatively sorted front
+to back, so hidden fragments are rejected by the depth test before shading,
+or drawn into the depth buffer first with an unshaded depth-only pass, after
+which only the visible fragments get shaded. The opaque packets can also be
+drawn with @ref setOverdrawVisualization() "overdraw visualization" to
+measure the effect. Packets added with plain @ref add(), such as instanced
+draws, take part in neither.
+*/
+class RenderQueue {
+    public:
+        /**
+         * @brief Queued object
+         *
+         * Called back from @ref flush() for each packet it added.
+         */
+        class Renderable {
+            public:
+                virtual ~Renderable();
+
+                /**
+                 * @brief Draw the packet
+                 * @param part              Part passed to @ref add()
+                 * @param materialChanged   Whether the shader or material
+                 *      differs from the previous packet. If `false`,
+                 *      material uniforms set by the previous packet are
+                 *      still in place and don't need to be uploaded again.
+                 * @return Count of uploaded uniforms
+                 */
+                virtual UnsignedInt submit(UnsignedInt part, bool materialChanged) = 0;
+        };
+
+        /** @brief Sort order of the main pass */
+        enum class SortOrder: UnsignedByte {
+            /** By shader, mesh and material, for least state changes */
+            State,
+
+            /**
+             * Opaque packets by distance from the camera, nearest first,
+             * then the rest by state
+             */
+            FrontToBack
+        };
+
+        /** @brief Per-frame statistics */
+        struct Statistics {
+            UnsignedInt draws;          /**< Submitted packets */
+            UnsignedInt unshadedDraws;  /**< Depth pre-pass and overdraw visualization draws */
+            UnsignedInt shaderBinds;    /**< Shader changes between packets */
+            UnsignedInt meshBinds;      /**< Mesh changes between packets */
+            UnsignedInt uniformUploads; /**< Uploaded uniforms */
+        };
+
+        /**
+         * @brief Material ID for given color
+         *
+         * For materials which differ only in color.
+         */
+        static UnsignedInt material(const Color3& color);
+
+        explicit RenderQueue();
+
+        ~RenderQueue();
+
+        /** @brief Sort order */
+        inline SortOrder sortOrder() const { return _sortOrder; }
+
+        /**
+         * @brief Set sort order
+         *
+         * Default is @ref SortOrder::State.
+         */
+        inline void setSortOrder(SortOrder order) { _sortOrder = order; }
+
+        /** @brief Whether depth pre-pass is enabled */
+        inline bool isDepthPrepassEnabled() const { return _depthPrepass; }
+
+        /**
+         * @brief Enable or disable depth pre-pass
+         *
+         * If enabled, @ref flush(const Matrix4&) first draws all opaque
+         * packets front to back with a depth-only shader and then draws
+         * everything with @ref Renderer::DepthFunction::LessOrEqual, so
+         * each pixel covered by opaque packets is shaded at most once.
+         * Packets which are not opaque, such as instanced draws, are not
+         * in the pre-pass and may still overdraw. Disabled by default.
+         */
+        inline void setDepthPrepass(bool enabled) { _depthPrepass = enabled; }
+
+        /** @brief Whether overdraw visualization is enabled */
+        inline bool isOverdrawVisualizationEnabled() const { return _overdrawVisualization; }
+
+        /**
+         * @brief Enable or disable overdraw visualization
+         *
+         * If enabled, @ref flush(const Matrix4&) draws opaque packets
+         * unshaded with additive blending instead of submitting them, each
+         * shaded fragment adds `0.125` to red and `0.0625` to green. Thus
+         * red means two or more fragments per pixel, yellow sixteen or
+         * more. The packets are drawn in the order given by
+         * @ref sortOrder(), or after the depth pre-pass, if enabled. Other
+         * packets, including instanced draws, are not drawn at all.
+         * Disabled by default.
+         */
+        inline void setOverdrawVisualization(bool enabled) { _overdrawVisualization = enabled; }
+
+        /**
+         * @brief Add draw packet
+         * @param shader        Shader used for the draw
+         * @param mesh          Drawn mesh
+         * @param material      Material ID, only lower 24 bits are used
+         * @param renderable    Object which draws the packet
+         * @param part          Passed back to @ref Renderable::submit()
+         */
+        void add(AbstractShaderProgram& shader, Mesh& mesh, UnsignedInt material, Renderable& renderable, UnsignedInt part = 0);
+
+        /**
+         * @brief Add opaque draw packet
+         * @param shader            Shader used for the draw
+         * @param mesh              Drawn mesh, must have position at
+         *      location compatible with @magnumref{Shaders::Phong}
+         * @param material          Material ID, only lower 24 bits are used
+         * @param renderable        Object which draws the packet
+         * @param transformation    Mesh transformation relative to the
+         *      camera, must stay valid until @ref flush()
+         * @param distance          Distance from the camera
+         * @param part              Passed back to @ref Renderable::submit()
+         *
+         * The packet takes part in front-to-back sorting, depth pre-pass
+         * and overdraw visualization.
+         */
+        void addOpaque(AbstractShaderProgram& shader, Mesh& mesh, UnsignedInt material, Renderable& renderable, const Matrix4& transformation, Float distance, UnsignedInt part = 0);
+
+        /**
+         * @brief Sort and submit all queued packets
+         *
+         * Depth pre-pass and overdraw visualization are not done, as the
+         * projection isn't known.
+         */
+        void flush();
+
+        /**
+         * @brief Sort and submit all queued packets with given projection
+         *
+         * Does depth pre-pass and overdraw visualization, if enabled.
+         */
+        void flush(const Matrix4& projectionMatrix);
+
+        /**
+         * @brief Count uniform uploads done outside of the queue
+         *
+         * Added to @ref Statistics::uniformUploads of current frame.
+         */
+        inline void addUniformUploads(UnsignedInt count) {
+            current.uniformUploads += count;
+        }
+
+        /** @brief Statistics of previous frame */
+        inline const Statistics& statistics() const { return _statistics; }
+
+        /**
+         * @brief Start next frame
+         *
+         * Called after buffer swap, saves statistics of the finished frame.
+         */
+        void nextFrame();
+
+    private:
+        struct Packet {
+            UnsignedLong key;
+            AbstractShaderProgram* shader;
+            Mesh* mesh;
+            Renderable* renderable;
+            UnsignedInt part;
+            const Matrix4* transformation;  /* null if not opaque */
+            Float distance;
+        };
+
+        void drawUnshaded(const Matrix4& projectionMatrix, const Color4& color);
+        void submit();
+
+        std::vector<Packet> packets;
+        Statistics _statistics, current;
+        SortOrder _sortOrder;
+        bool _depthPrepass, _overdrawVisualization;
+        std::unique_ptr<Shaders::Unshaded> unshadedShader;
+};
+
+}}
+
+#endif
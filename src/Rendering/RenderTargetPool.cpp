@@ -0,0 +1,98 @@
+#include "RenderTargetPool.h"
+
+#include <algorithm>
+#include <Magnum/Renderbuffer.h>
+#include <Magnum/RenderbufferFormat.h>
+#include <Magnum/Texture.h>
+#include <Magnum/TextureFormat.h>
+
+namespace PushTheBox { namespace Rendering {
+
+namespace {
+
+/* Released targets older than this are deleted. Measured in time and not in
+   drawn frames, as nothing is drawn while waiting for input. */
+constexpr std::chrono::seconds MaxUnusedTime{5};
+
+template<class T> std::size_t pixels(const std::vector<T>& targets) {
+    std::size_t count = 0;
+    for(const T& target: targets)
+        count += target.size.product()*std::max(target.sampleCount, 1);
+    return count;
+}
+
+template<class T> void releaseTarget(std::vector<T>& targets, const void* object) {
+    for(T& target: targets) if(target.object.get() == object) {
+        CORRADE_ASSERT(target.used, "Rendering::RenderTargetPool::release(): target already released", );
+        target.used = false;
+        target.released = std::chrono::steady_clock::now();
+        return;
+    }
+
+    CORRADE_ASSERT(false, "Rendering::RenderTargetPool::release(): target not from this pool", );
+}
+
+template<class T> void trimTargets(std::vector<T>& targets, const std::chrono::steady_clock::time_point maxReleased) {
+    targets.erase(std::remove_if(targets.begin(), targets.end(), [maxReleased](const T& target) {
+        return !target.used && target.released <= maxReleased;
+    }), targets.end());
+}
+
+}
+
+RenderTargetPool::RenderTargetPool() = default;
+
+RenderTargetPool::~RenderTargetPool() = default;
+
+Texture2D& RenderTargetPool::acquireTexture(const TextureFormat format, const Vector2i& size) {
+    for(Target<Texture2D, TextureFormat>& target: textures) {
+        if(target.used || target.format != format || target.size != size) continue;
+        target.used = true;
+        return *target.object;
+    }
+
+    std::unique_ptr<Texture2D> texture{new Texture2D};
+    texture->setStorage(1, format, size);
+    textures.push_back({format, size, 0, true, {}, std::move(texture)});
+    return *textures.back().object;
+}
+
+Renderbuffer& RenderTargetPool::acquireRenderbuffer(const RenderbufferFormat format, const Vector2i& size, const Int sampleCount) {
+    for(Target<Renderbuffer, RenderbufferFormat>& target: renderbuffers) {
+        if(target.used || target.format != format || target.size != size || target.sampleCount != sampleCount) continue;
+        target.used = true;
+        return *target.object;
+    }
+
+    std::unique_ptr<Renderbuffer> renderbuffer{new Renderbuffer};
+    if(sampleCount) renderbuffer->setStorageMultisample(sampleCount, format, size);
+    else renderbuffer->setStorage(format, size);
+    renderbuffers.push_back({format, size, sampleCount, true, {}, std::move(renderbuffer)});
+    return *renderbuffers.back().object;
+}
+
+void RenderTargetPool::release(Texture2D& texture) {
+    releaseTarget(textures, &texture);
+}
+
+void RenderTargetPool::release(Renderbuffer& renderbuffer) {
+    releaseTarget(renderbuffers, &renderbuffer);
+}
+
+void RenderTargetPool::trim() {
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    trimTargets(textures, now);
+    trimTargets(renderbuffers, now);
+}
+
+void RenderTargetPool::nextFrame() {
+    const std::chrono::steady_clock::time_point maxReleased = std::chrono::steady_clock::now() - MaxUnusedTime;
+    trimTargets(textures, maxReleased);
+    trimTargets(renderbuffers, maxReleased);
+}
+
+std::size_t RenderTargetPool::pixelCount() const {
+    return pixels(textures) + pixels(renderbuffers);
+}
+
+}}
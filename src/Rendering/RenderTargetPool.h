@@ -0,0 +1,102 @@
+#ifndef PushTheBox_Rendering_RenderTargetPool_h
+#define PushTheBox_Rendering_RenderTargetPool_h
+
+/** @file
+ * @brief Class PushTheBox::Rendering::RenderTargetPool
+ */
+
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Vector2.h>
+
+#include "PushTheBox.h"
+
+namespace PushTheBox { namespace Rendering {
+
+/**
+@brief Render target pool
+
+Hands out offscreen textures and renderbuffers by format and size. Released
+targets stay allocated and are handed out again to the next request with the
+same parameters, so switching effects on and off doesn't reallocate GPU
+memory every time. Targets released more than a few seconds ago, e.g. ones
+left from previous dynamic resolution scales or blur targets after the game
+is unpaused, are deleted in @ref nextFrame(), all released targets are
+deleted on @ref trim().
+*/
+class RenderTargetPool {
+    public:
+        explicit RenderTargetPool();
+
+        ~RenderTargetPool();
+
+        /**
+         * @brief Acquire texture
+         *
+         * The texture has one level of given format and size. Sampler state
+         * is left from previous user, set it after acquiring. The texture
+         * is not handed out again until it's released.
+         */
+        Texture2D& acquireTexture(TextureFormat format, const Vector2i& size);
+
+        /**
+         * @brief Acquire renderbuffer
+         *
+         * If @p sampleCount is not zero, the renderbuffer is multisampled.
+         * The renderbuffer is not handed out again until it's released.
+         */
+        Renderbuffer& acquireRenderbuffer(RenderbufferFormat format, const Vector2i& size, Int sampleCount = 0);
+
+        /** @brief Return texture to the pool */
+        void release(Texture2D& texture);
+
+        /** @brief Return renderbuffer to the pool */
+        void release(Renderbuffer& renderbuffer);
+
+        /**
+         * @brief Delete all targets which are not in use
+         *
+         * Called when none of the released targets is going to be needed
+         * again, e.g. after a window resize.
+         */
+        void trim();
+
+        /**
+         * @brief Start next frame
+         *
+         * Called after buffer swap, deletes targets released more than five
+         * seconds ago. Nothing is deleted while no frames are drawn, the
+         * next frame after that deletes all of them at once.
+         */
+        void nextFrame();
+
+        /** @brief Count of allocated targets */
+        std::size_t targetCount() const { return textures.size() + renderbuffers.size(); }
+
+        /**
+         * @brief Count of allocated pixels
+         *
+         * Sum over all targets, including the released ones. Multisampled
+         * renderbuffers count each sample.
+         */
+        std::size_t pixelCount() const;
+
+    private:
+        template<class T, class Format> struct Target {
+            Format format;
+            Vector2i size;
+            Int sampleCount;
+            bool used;
+            std::chrono::steady_clock::time_point released;
+            std::unique_ptr<T> object;
+        };
+
+        std::vector<Target<Texture2D, TextureFormat>> textures;
+        std::vector<Target<Renderbuffer, RenderbufferFormat>> renderbuffers;
+};
+
+}}
+
+#endif
@@ -0,0 +1,70 @@
+#include "ResolutionScaler.h"
+
+#include <Corrade/Utility/Assert.h>
+#include <Magnum/Math/Functions.h>
+
+namespace PushTheBox { namespace Rendering {
+
+namespace {
+    /* Going down is in larger steps than going up, so the recovery from a
+       heavy scene is quick and the resolution creeps back carefully */
+    constexpr Float StepDown = 0.1f;
+    constexpr Float StepUp = 0.05f;
+
+    /* Frames on one side of the limit needed for a change, ~0.5 s at 60 FPS */
+    constexpr Int WindowSize = 30;
+
+    /* Weight of new frame in the running average */
+    constexpr Float AverageWeight = 0.1f;
+
+    /* Relative headroom under the target needed to go up, so a frame just
+       fitting in the target doesn't go up only to go down right after */
+    constexpr Float Headroom = 0.15f;
+}
+
+ResolutionScaler::ResolutionScaler(Float minScale, Float maxScale, Float targetFrameDuration): _scale(maxScale), targetFrameDuration(targetFrameDuration), _hysteresis(0.0f) {
+    setScaleLimits(minScale, maxScale);
+    reset();
+}
+
+ResolutionScaler& ResolutionScaler::setScaleLimits(Float min, Float max) {
+    CORRADE_ASSERT(min > 0.0f && min <= max, "Rendering::ResolutionScaler::setScaleLimits(): invalid limits" << min << max, *this);
+    _minScale = min;
+    _maxScale = max;
+    _scale = Math::clamp(_scale, min, max);
+    return *this;
+}
+
+bool ResolutionScaler::addFrame(Float duration) {
+    averageDuration = averageDuration == 0.0f ? duration :
+        Math::lerp(averageDuration, duration, AverageWeight);
+
+    /* Count consecutive frames over the limit and under the target, frames
+       in between reset both */
+    if(averageDuration > targetFrameDuration*(1.0f + _hysteresis)) {
+        ++overCount;
+        underCount = 0;
+    } else if(averageDuration < targetFrameDuration*(1.0f - Headroom)) {
+        ++underCount;
+        overCount = 0;
+    } else overCount = underCount = 0;
+
+    Float scale = _scale;
+    if(overCount >= WindowSize) scale = Math::max(_scale - StepDown, _minScale);
+    else if(underCount >= WindowSize) scale = Math::min(_scale + StepUp, _maxScale);
+    else return false;
+
+    /* Start over, the new resolution needs its own measurements */
+    overCount = underCount = 0;
+    if(scale == _scale) return false;
+    _scale = scale;
+    averageDuration = 0.0f;
+    return true;
+}
+
+void ResolutionScaler::reset() {
+    averageDuration = 0.0f;
+    overCount = underCount = 0;
+}
+
+}}
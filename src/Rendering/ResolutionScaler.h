@@ -0,0 +1,92 @@
+#ifndef PushTheBox_Rendering_ResolutionScaler_h
+#define PushTheBox_Rendering_ResolutionScaler_h
+
+/** @file
+ * @brief Class PushTheBox::Rendering::ResolutionScaler
+ */
+
+#include <Magnum/Magnum.h>
+
+#include "PushTheBox.h"
+
+namespace PushTheBox { namespace Rendering {
+
+/**
+@brief Dynamic resolution controller
+
+Picks render resolution scale from recent frame durations. The durations are
+averaged and the scale goes down one step when the average is over the
+target duration by more than @ref setHysteresis() "hysteresis" and up one
+step when it's at least 15% below the target. Each change must be preceded
+by a whole window of frames all on the same side and the average starts over
+after it, so the scale doesn't oscillate around the limit and a single hitch
+doesn't drop the resolution.
+
+The durations are expected to be the time spent working on the frame, not
+the time between buffer swaps. With vertical sync the latter never goes
+under the refresh interval, so the scale would never go back up.
+*/
+class ResolutionScaler {
+    public:
+        /**
+         * @brief Constructor
+         * @param minScale              Smallest allowed scale
+         * @param maxScale              Largest allowed scale, also the
+         *      initial one
+         * @param targetFrameDuration   Frame duration to stay under, in
+         *      seconds
+         */
+        explicit ResolutionScaler(Float minScale = 0.5f, Float maxScale = 1.0f, Float targetFrameDuration = 1.0f/60.0f);
+
+        /** @brief Current scale */
+        inline Float scale() const { return _scale; }
+
+        /** @brief Smallest allowed scale */
+        inline Float minScale() const { return _minScale; }
+
+        /** @brief Largest allowed scale */
+        inline Float maxScale() const { return _maxScale; }
+
+        /**
+         * @brief Set scale limits
+         *
+         * The current scale is clamped to the new limits.
+         */
+        ResolutionScaler& setScaleLimits(Float min, Float max);
+
+        /**
+         * @brief Set hysteresis
+         *
+         * Relative amount the average frame duration must exceed the
+         * target to lower the resolution. Default is `0.0f`, the frame
+         * duration has to be under the target by 15% to raise it, which
+         * already keeps the scale from oscillating.
+         */
+        ResolutionScaler& setHysteresis(Float hysteresis) {
+            _hysteresis = hysteresis;
+            return *this;
+        }
+
+        /**
+         * @brief Add frame duration
+         * @return `True` if the scale changed, `false` otherwise
+         *
+         * Feed the CPU or GPU time spent drawing the frame, whichever is
+         * longer. Time spent idle waiting for input or for vertical sync
+         * would look like a slow frame.
+         */
+        bool addFrame(Float duration);
+
+        /** @brief Forget collected frame durations */
+        void reset();
+
+    private:
+        Float _minScale, _maxScale, _scale;
+        Float targetFrameDuration, _hysteresis;
+        Float averageDuration;
+        Int overCount, underCount;
+};
+
+}}
+
+#endif
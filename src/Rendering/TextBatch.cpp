@@ -0,0 +1,194 @@
+#include "TextBatch.h"
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Utility/Assert.h>
+#include <Magnum/ResourceManager.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Text/AbstractFont.h>
+#include <Magnum/Text/Alignment.h>
+#include <Magnum/Text/GlyphCache.h>
+
+#include "Application.h"
+#include "Shaders/BatchedText.h"
+
+namespace PushTheBox { namespace Rendering {
+
+namespace {
+    Vector2 alignmentOffset(const Range2D& rectangle, const Text::Alignment alignment) {
+        Vector2 offset;
+
+        switch(alignment) {
+            case Text::Alignment::LineLeft:
+            case Text::Alignment::MiddleLeft:
+            case Text::Alignment::TopLeft:
+                offset.x() = -rectangle.left();
+                break;
+            case Text::Alignment::LineCenter:
+            case Text::Alignment::MiddleCenter:
+            case Text::Alignment::TopCenter:
+                offset.x() = -rectangle.centerX();
+                break;
+            case Text::Alignment::LineRight:
+            case Text::Alignment::MiddleRight:
+            case Text::Alignment::TopRight:
+                offset.x() = -rectangle.right();
+                break;
+        }
+
+        switch(alignment) {
+            case Text::Alignment::LineLeft:
+            case Text::Alignment::LineCenter:
+            case Text::Alignment::LineRight:
+                break;
+            case Text::Alignment::MiddleLeft:
+            case Text::Alignment::MiddleCenter:
+            case Text::Alignment::MiddleRight:
+                offset.y() = -rectangle.centerY();
+                break;
+            case Text::Alignment::TopLeft:
+            case Text::Alignment::TopCenter:
+            case Text::Alignment::TopRight:
+                offset.y() = -rectangle.top();
+                break;
+        }
+
+        return offset;
+    }
+}
+
+TextBatch::TextBatch(const Color4& outlineColor, const Vector2& outlineRange): _font(SceneResourceManager::instance().get<Text::AbstractFont>("font")), _glyphCache(SceneResourceManager::instance().get<Text::GlyphCache>("cache")), shader(SceneResourceManager::instance().get<AbstractShaderProgram, Shaders::BatchedText>("batched-text")), outlineColor(outlineColor), outlineRange(outlineRange), uploadedVertexCount(0), vertexBuffer(Buffer::TargetHint::Array), indexBuffer(Buffer::TargetHint::ElementArray) {
+    mesh.setPrimitive(MeshPrimitive::Triangles)
+        .addVertexBuffer(vertexBuffer, 0,
+            Shaders::BatchedText::Position(),
+            Shaders::BatchedText::TextureCoordinates(),
+            Shaders::BatchedText::Transformation(),
+            Shaders::BatchedText::Color());
+}
+
+TextBatch::~TextBatch() = default;
+
+UnsignedInt TextBatch::add(const UnsignedInt glyphCapacity, const Color3& color) {
+    const UnsignedInt offset = vertices.size();
+    CORRADE_ASSERT(offset + glyphCapacity*4 <= 65536, "Rendering::TextBatch::add(): too many glyphs", {});
+
+    entries.push_back({offset, glyphCapacity, Vector3::zAxis(1.0f), color, true});
+    vertices.resize(offset + glyphCapacity*4, Vertex{{}, {}, Vector3::zAxis(1.0f), color});
+    return entries.size() - 1;
+}
+
+Range2D TextBatch::setText(const UnsignedInt id, const std::string& text, const Float size, const Text::Alignment alignment) {
+    Entry& entry = entries[id];
+
+    /* Lay out the glyphs */
+    std::unique_ptr<Text::AbstractLayouter> layouter = _font->layout(*_glyphCache, size, text);
+    const UnsignedInt glyphCount = Math::min(layouter->glyphCount(), entry.capacity);
+    Vector2 cursor;
+    Range2D rectangle;
+    for(UnsignedInt i = 0; i != glyphCount; ++i) {
+        Range2D position, textureCoordinates;
+        std::tie(position, textureCoordinates) = layouter->renderGlyph(i, cursor, rectangle);
+        setGlyph(id, i, position, textureCoordinates);
+    }
+
+    /* Hide the rest */
+    for(UnsignedInt i = glyphCount; i != entry.capacity; ++i)
+        setGlyph(id, i, {}, {});
+
+    /* Align */
+    const Vector2 offset = alignmentOffset(rectangle, alignment);
+    for(UnsignedInt i = 0; i != glyphCount*4; ++i)
+        vertices[entry.offset + i].position += offset;
+
+    return rectangle.translated(offset);
+}
+
+void TextBatch::setGlyph(const UnsignedInt id, const UnsignedInt i, const Range2D& position, const Range2D& textureCoordinates) {
+    Entry& entry = entries[id];
+    CORRADE_INTERNAL_ASSERT(i < entry.capacity);
+
+    Vertex* const quad = vertices.data() + entry.offset + i*4;
+    quad[0] = {position.topLeft(), textureCoordinates.topLeft(), entry.transformation, entry.color};
+    quad[1] = {position.bottomLeft(), textureCoordinates.bottomLeft(), entry.transformation, entry.color};
+    quad[2] = {position.topRight(), textureCoordinates.topRight(), entry.transformation, entry.color};
+    quad[3] = {position.bottomRight(), textureCoordinates.bottomRight(), entry.transformation, entry.color};
+    entry.dirty = true;
+}
+
+void TextBatch::setTransformation(const UnsignedInt id, const Vector2& translation, const Float scale) {
+    Entry& entry = entries[id];
+    const Vector3 transformation{translation, scale};
+    if(entry.transformation == transformation) return;
+
+    entry.transformation = transformation;
+    for(UnsignedInt i = 0; i != entry.capacity*4; ++i)
+        vertices[entry.offset + i].transformation = transformation;
+    entry.dirty = true;
+}
+
+void TextBatch::setColor(const UnsignedInt id, const Color3& color) {
+    Entry& entry = entries[id];
+    if(entry.color == color) return;
+
+    entry.color = color;
+    for(UnsignedInt i = 0; i != entry.capacity*4; ++i)
+        vertices[entry.offset + i].color = color;
+    entry.dirty = true;
+}
+
+void TextBatch::upload() {
+    /* Texts were added, upload everything and extend the indices */
+    if(vertices.size() != uploadedVertexCount) {
+        std::vector<UnsignedShort> indices;
+        indices.reserve(vertices.size()/4*6);
+        for(UnsignedInt i = 0; i != vertices.size(); i += 4)
+            for(UnsignedInt index: {0, 1, 2, 1, 3, 2}) indices.push_back(i + index);
+
+        vertexBuffer.setData(Containers::ArrayView<const Vertex>{vertices.data(), vertices.size()}, BufferUsage::DynamicDraw);
+        indexBuffer.setData(Containers::ArrayView<const UnsignedShort>{indices.data(), indices.size()}, BufferUsage::StaticDraw);
+        mesh.setCount(indices.size())
+            .setIndexBuffer(indexBuffer, 0, Mesh::IndexType::UnsignedShort, 0, vertices.size() - 1);
+
+        uploadedVertexCount = vertices.size();
+        for(Entry& entry: entries) entry.dirty = false;
+        return;
+    }
+
+    /* Upload each run of consecutive changed texts at once */
+    for(std::size_t i = 0; i != entries.size(); ) {
+        if(!entries[i].dirty) {
+            ++i;
+            continue;
+        }
+
+        const UnsignedInt begin = entries[i].offset;
+        UnsignedInt end = begin;
+        for(; i != entries.size() && entries[i].dirty; ++i) {
+            end = entries[i].offset + entries[i].capacity*4;
+            entries[i].dirty = false;
+        }
+
+        vertexBuffer.setSubData(begin*sizeof(Vertex), Containers::ArrayView<const Vertex>{vertices.data() + begin, end - begin});
+    }
+}
+
+void TextBatch::draw(const Matrix3& projectionMatrix) {
+    if(vertices.empty()) return;
+
+    upload();
+    this->projectionMatrix = projectionMatrix;
+    Application::instance()->renderQueue().add(*shader, mesh, RenderQueue::material(outlineColor.rgb()), *this);
+}
+
+UnsignedInt TextBatch::submit(UnsignedInt, const bool materialChanged) {
+    shader->setProjectionMatrix(projectionMatrix);
+    if(materialChanged) {
+        shader->setOutlineColor(outlineColor)
+            .setOutlineRange(outlineRange.x(), outlineRange.y())
+            .setVectorTexture(_glyphCache->texture());
+    }
+
+    mesh.draw(*shader);
+    return materialChanged ? 3 : 1;
+}
+
+}}
@@ -0,0 +1,138 @@
+#ifndef PushTheBox_Rendering_TextBatch_h
+#define PushTheBox_Rendering_TextBatch_h
+
+/** @file
+ * @brief Class PushTheBox::Rendering::TextBatch
+ */
+
+#include <string>
+#include <vector>
+#include <Magnum/Buffer.h>
+#include <Magnum/Color.h>
+#include <Magnum/Mesh.h>
+#include <Magnum/Resource.h>
+#include <Magnum/Math/Range.h>
+#include <Magnum/Text/Text.h>
+
+#include "PushTheBox.h"
+#include "Rendering/RenderQueue.h"
+
+namespace PushTheBox {
+
+namespace Shaders {
+    class BatchedText;
+}
+
+namespace Rendering {
+
+/**
+@brief Text batch
+
+Packs many texts using the shared font and glyph cache into a single vertex
+buffer, so all of them are drawn with one call. Each text has a fixed glyph
+capacity reserved when it's added and its translation, scale and color are
+stored in its vertices. Changing a text only marks its range of the buffer,
+@ref draw() then uploads just the changed ranges.
+
+Texts can't be removed, only emptied by setting an empty string.
+*/
+class TextBatch: public RenderQueue::Renderable {
+    public:
+        /**
+         * @brief Constructor
+         * @param outlineColor  Outline color, common for all texts
+         * @param outlineRange  Outline range, no outline by default
+         */
+        explicit TextBatch(const Color4& outlineColor = {}, const Vector2& outlineRange = {0.5f, 1.0f});
+
+        ~TextBatch();
+
+        /** @brief Font */
+        Text::AbstractFont& font() { return *_font; }
+
+        /** @brief Glyph cache */
+        Text::GlyphCache& glyphCache() { return *_glyphCache; }
+
+        /**
+         * @brief Add text
+         * @param glyphCapacity Max count of glyphs in the text
+         * @param color         Fill color
+         * @return Text ID
+         *
+         * The text is initially empty.
+         */
+        UnsignedInt add(UnsignedInt glyphCapacity, const Color3& color = Color3(1.0f));
+
+        /**
+         * @brief Lay out text
+         * @return Bounding rectangle of the aligned text
+         *
+         * Glyphs above the capacity given in @ref add() are dropped.
+         */
+        Range2D setText(UnsignedInt id, const std::string& text, Float size, Text::Alignment alignment);
+
+        /**
+         * @brief Set single glyph of a text
+         *
+         * For texts which are laid out by the caller and updated only
+         * partially. Pass default-constructed ranges to hide the glyph.
+         */
+        void setGlyph(UnsignedInt id, UnsignedInt i, const Range2D& position, const Range2D& textureCoordinates);
+
+        /**
+         * @brief Set text transformation
+         *
+         * Does nothing if the transformation didn't change.
+         */
+        void setTransformation(UnsignedInt id, const Vector2& translation, Float scale = 1.0f);
+
+        /**
+         * @brief Set text color
+         *
+         * Does nothing if the color didn't change.
+         */
+        void setColor(UnsignedInt id, const Color3& color);
+
+        /**
+         * @brief Draw all texts
+         *
+         * Uploads changed ranges and adds a single packet to the render
+         * queue.
+         */
+        void draw(const Matrix3& projectionMatrix);
+
+    private:
+        struct Vertex {
+            Vector2 position;
+            Vector2 textureCoordinates;
+            Vector3 transformation;
+            Color3 color;
+        };
+
+        struct Entry {
+            UnsignedInt offset, capacity;
+            Vector3 transformation;
+            Color3 color;
+            bool dirty;
+        };
+
+        UnsignedInt submit(UnsignedInt part, bool materialChanged) override;
+        void upload();
+
+        Resource<Text::AbstractFont> _font;
+        Resource<Text::GlyphCache> _glyphCache;
+        Resource<AbstractShaderProgram, Shaders::BatchedText> shader;
+        Color4 outlineColor;
+        Vector2 outlineRange;
+
+        std::vector<Vertex> vertices;
+        std::vector<Entry> entries;
+        std::size_t uploadedVertexCount;
+        Buffer vertexBuffer, indexBuffer;
+        Mesh mesh;
+        Matrix3 projectionMatrix;
+};
+
+}}
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef PushTheBox_Rendering_TripleBuffer_h
+#define PushTheBox_Rendering_TripleBuffer_h
+
+/** @file
+ * @brief Class PushTheBox::Rendering::TripleBuffer
+ */
+
+#include <atomic>
+#include <Magnum/Magnum.h>
+
+#include "PushTheBox.h"
+
+namespace PushTheBox { namespace Rendering {
+
+/**
+@brief Lock-free triple buffer
+
+Passes the latest value from one writer thread to one reader thread without
+locking and without either of them ever waiting. The writer fills
+@ref write() and calls @ref publish(), the reader calls @ref update() and
+reads @ref read(). Values published while the reader wasn't looking are
+dropped, only the newest one is kept.
+
+The buffer returned by @ref write() after @ref publish() contains an older
+value, so the writer is expected to overwrite it completely. Reusing the
+buffers avoids allocations if @p T contains containers.
+*/
+template<class T> class TripleBuffer {
+    public:
+        /** @brief Constructor */
+        explicit TripleBuffer(): writeIndex(0), readIndex(2), middle(1) {}
+
+        /** @brief Copying is not allowed */
+        TripleBuffer(const TripleBuffer<T>&) = delete;
+
+        /** @brief Copying is not allowed */
+        TripleBuffer<T>& operator=(const TripleBuffer<T>&) = delete;
+
+        /** @brief Buffer to write next value into, writer thread only */
+        inline T& write() { return buffers[writeIndex]; }
+
+        /**
+         * @brief Publish the written value, writer thread only
+         *
+         * Swaps the written buffer with the middle one and marks it as new.
+         */
+        inline void publish() {
+            writeIndex = middle.exchange(writeIndex|Fresh, std::memory_order_acq_rel) & IndexMask;
+        }
+
+        /**
+         * @brief Take the newest published value, reader thread only
+         * @return `true` if there was a new value since the last call,
+         *      `false` otherwise
+         */
+        inline bool update() {
+            if(!(middle.load(std::memory_order_acquire) & Fresh)) return false;
+            readIndex = middle.exchange(readIndex, std::memory_order_acq_rel) & IndexMask;
+            return true;
+        }
+
+        /**
+         * @brief Current value, reader thread only
+         *
+         * Default-constructed value until something is published.
+         */
+        inline const T& read() const { return buffers[readIndex]; }
+
+    private:
+        enum: UnsignedByte {
+            IndexMask = 0x03,
+            Fresh = 0x04
+        };
+
+        T buffers[3];
+        UnsignedByte writeIndex, readIndex;
+        std::atomic<UnsignedByte> middle;
+};
+
+}}
+
+#endif
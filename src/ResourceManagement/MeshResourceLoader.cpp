@@ -7,6 +7,8 @@
 #include <Magnum/Resource.h>
 #include <Magnum/Shaders/Phong.h>
 
+#include "Rendering/CpuProfiler.h"
+
 namespace PushTheBox { namespace ResourceManagement {
 
 MeshResourceLoader::MeshResourceLoader() {
@@ -29,6 +31,8 @@ std::string MeshResourceLoader::name(ResourceKey key) const {
 }
 
 void MeshResourceLoader::doLoad(ResourceKey key) {
+    PUSHTHEBOX_PROFILE_SCOPE("MeshResourceLoader::doLoad");
+
     auto it = nameMap.find(key);
     Utility::ConfigurationGroup* group;
     if(it == nameMap.end() || !(group = conf->group("mesh", it->second))) {
@@ -37,46 +41,86 @@ void MeshResourceLoader::doLoad(ResourceKey key) {
         return;
     }
 
-    /* Mesh */
-    Mesh* mesh = new Mesh;
-    mesh->setPrimitive(group->value<MeshPrimitive>("primitive"));
-
-    /* Indexed mesh */
+    /* Add index buffer to the manager, if the mesh is indexed */
+    Buffer* indexBuffer = nullptr;
     if(group->hasValue("indexOffset")) {
-
-        /* Add index buffer to the manager */
-        Buffer* indexBuffer = new Buffer(Buffer::TargetHint::ElementArray);
+        indexBuffer = new Buffer(Buffer::TargetHint::ElementArray);
         SceneResourceManager::instance().set(group->value("name") + "-index", indexBuffer, ResourceDataState::Final, ResourcePolicy::Resident);
-
-        /* Configure indices */
-        Int indexCount = group->value<Int>("indexCount");
-        Mesh::IndexType indexType = group->value<Mesh::IndexType>("indexType");
-        mesh->setCount(indexCount)
-            .setIndexBuffer(*indexBuffer, 0, indexType,
-                group->value<UnsignedInt>("indexStart"), group->value<UnsignedInt>("indexEnd"));
         indexBuffer->setData({data.begin()+group->value<std::size_t>("indexOffset"),
-            indexCount*Mesh::indexSize(indexType)},
+            group->value<Int>("indexCount")*Mesh::indexSize(group->value<Mesh::IndexType>("indexType"))},
             BufferUsage::StaticDraw);
-
-    /* Non-indexed mesh */
-    } else mesh->setCount(group->value<Int>("vertexCount"));
+    }
 
     /* Add vertex buffer to the manager */
     Buffer* vertexBuffer = new Buffer;
     SceneResourceManager::instance().set(group->value("name") + "-vertex", vertexBuffer, ResourceDataState::Final, ResourcePolicy::Resident);
-
-    /* Configure vertices */
-    mesh->setPrimitive(group->value<MeshPrimitive>("primitive"))
-        .addVertexBuffer(*vertexBuffer, 0,
-            Shaders::Phong::Position(),
-            Shaders::Phong::Normal(Shaders::Phong::Normal::DataType::Byte, Shaders::Phong::Normal::DataOption::Normalized),
-            1);
     vertexBuffer->setData({data.begin()+group->value<std::size_t>("vertexOffset"),
                           group->value<Int>("vertexCount")*group->value<std::size_t>("vertexStride")},
                           BufferUsage::StaticDraw);
 
+    /* Mesh */
+    Mesh* mesh = new Mesh;
+    configure(*group, *mesh, *vertexBuffer, indexBuffer);
+
     /* Finally add the mesh to the manager */
     set(key, mesh, ResourceDataState::Final, ResourcePolicy::Resident);
 }
 
+bool MeshResourceLoader::setupMesh(ResourceKey key, Mesh& mesh) {
+    auto it = nameMap.find(key);
+    if(it == nameMap.end()) return false;
+    const Utility::ConfigurationGroup& group = *conf->group("mesh", it->second);
+
+    /* Make sure the buffers are loaded */
+    SceneResourceManager::instance().get<Mesh>(key);
+    Resource<Buffer> vertexBuffer = SceneResourceManager::instance().get<Buffer>(group.value("name") + "-vertex");
+    Resource<Buffer> indexBuffer = SceneResourceManager::instance().get<Buffer>(group.value("name") + "-index");
+
+    configure(group, mesh, *vertexBuffer, group.hasValue("indexOffset") ? &*indexBuffer : nullptr);
+    return true;
+}
+
+bool MeshResourceLoader::meshData(ResourceKey key, MeshData& data) const {
+    auto it = nameMap.find(key);
+    if(it == nameMap.end()) return false;
+    const Utility::ConfigurationGroup& group = *conf->group("mesh", it->second);
+
+    data.primitive = group.value<MeshPrimitive>("primitive");
+    if(group.hasValue("indexOffset")) {
+        data.indexType = group.value<Mesh::IndexType>("indexType");
+        data.indexCount = group.value<UnsignedInt>("indexCount");
+        data.indices = {this->data.begin()+group.value<std::size_t>("indexOffset"),
+            data.indexCount*Mesh::indexSize(data.indexType)};
+    } else {
+        data.indexType = Mesh::IndexType::UnsignedInt;
+        data.indexCount = 0;
+        data.indices = nullptr;
+    }
+
+    data.vertexCount = group.value<UnsignedInt>("vertexCount");
+    data.vertexStride = group.value<std::size_t>("vertexStride");
+    data.vertices = {this->data.begin()+group.value<std::size_t>("vertexOffset"),
+        data.vertexCount*data.vertexStride};
+    return true;
+}
+
+void MeshResourceLoader::configure(const Utility::ConfigurationGroup& group, Mesh& mesh, Buffer& vertexBuffer, Buffer* indexBuffer) const {
+    mesh.setPrimitive(group.value<MeshPrimitive>("primitive"));
+
+    /* Indexed mesh */
+    if(indexBuffer) {
+        mesh.setCount(group.value<Int>("indexCount"))
+            .setIndexBuffer(*indexBuffer, 0, group.value<Mesh::IndexType>("indexType"),
+                group.value<UnsignedInt>("indexStart"), group.value<UnsignedInt>("indexEnd"));
+
+    /* Non-indexed mesh */
+    } else mesh.setCount(group.value<Int>("vertexCount"));
+
+    /* Configure vertices */
+    mesh.addVertexBuffer(vertexBuffer, 0,
+        Shaders::Phong::Position(),
+        Shaders::Phong::Normal(Shaders::Phong::Normal::DataType::Byte, Shaders::Phong::Normal::DataOption::Normalized),
+        1);
+}
+
 }}
@@ -4,6 +4,7 @@
 #include <Corrade/Containers/ArrayView.h>
 #include <Corrade/Utility/Configuration.h>
 #include <Magnum/AbstractResourceLoader.h>
+#include <Magnum/Mesh.h>
 
 #include "PushTheBox.h"
 
@@ -21,13 +22,53 @@ namespace Implementation {
 
 class MeshResourceLoader: public AbstractResourceLoader<Mesh> {
     public:
+        /**
+         * @brief Raw mesh data
+         *
+         * Vertices are interleaved three-component float positions and
+         * three-component normalized byte normals, padded to four bytes.
+         */
+        struct MeshData {
+            MeshPrimitive primitive;
+            Mesh::IndexType indexType;
+            UnsignedInt indexCount;
+            Containers::ArrayView<const char> indices; /**< Empty if not indexed */
+            UnsignedInt vertexCount;
+            std::size_t vertexStride;
+            Containers::ArrayView<const char> vertices;
+        };
+
         MeshResourceLoader();
 
         std::string name(ResourceKey key) const;
 
+        /** @brief Whether given mesh exists */
+        inline bool contains(ResourceKey key) const {
+            return nameMap.find(key) != nameMap.end();
+        }
+
+        /**
+         * @brief Set up another mesh sharing data of given mesh resource
+         * @return `False` if the resource was not found, `true` otherwise
+         *
+         * Loads the resource, if not already, and configures primitive,
+         * count and vertex and index buffers of @p mesh the same way. Used
+         * for meshes which have additional (e.g. instanced) attributes.
+         */
+        bool setupMesh(ResourceKey key, Mesh& mesh);
+
+        /**
+         * @brief Raw data of given mesh
+         * @return `False` if the resource was not found, `true` otherwise
+         *
+         * Used for processing the meshes on the CPU side, e.g. merging
+         * them into larger ones.
+         */
+        bool meshData(ResourceKey key, MeshData& data) const;
 
     private:
         void doLoad(ResourceKey key) override;
+        void configure(const Utility::ConfigurationGroup& group, Mesh& mesh, Buffer& vertexBuffer, Buffer* indexBuffer) const;
 
         std::unordered_map<ResourceKey, std::uint32_t, Implementation::ResourceKeyHash> nameMap;
 
@@ -0,0 +1,319 @@
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <queue>
+#include <set>
+#include <tuple>
+#include <Magnum/Math/Functions.h>
+
+namespace PushTheBox { namespace ResourceManagement {
+
+namespace {
+
+/* Symmetric 4x4 matrix measuring squared distance to a set of planes */
+struct Quadric {
+    Double a[10];
+
+    Quadric(): a{} {}
+
+    /* Plane with unit normal n going through point p */
+    static Quadric plane(const Vector3& n, const Vector3& p, Double weight = 1.0) {
+        const Double x = n.x(), y = n.y(), z = n.z(), d = -Math::dot(n, p);
+        Quadric q;
+        q.a[0] = weight*x*x; q.a[1] = weight*x*y; q.a[2] = weight*x*z; q.a[3] = weight*x*d;
+        q.a[4] = weight*y*y; q.a[5] = weight*y*z; q.a[6] = weight*y*d;
+        q.a[7] = weight*z*z; q.a[8] = weight*z*d;
+        q.a[9] = weight*d*d;
+        return q;
+    }
+
+    Quadric& operator+=(const Quadric& other) {
+        for(std::size_t i = 0; i != 10; ++i) a[i] += other.a[i];
+        return *this;
+    }
+
+    Quadric operator+(const Quadric& other) const {
+        return Quadric(*this) += other;
+    }
+
+    Double error(const Vector3& v) const {
+        const Double x = v.x(), y = v.y(), z = v.z();
+        return a[0]*x*x + 2*a[1]*x*y + 2*a[2]*x*z + 2*a[3]*x +
+               a[4]*y*y + 2*a[5]*y*z + 2*a[6]*y +
+               a[7]*z*z + 2*a[8]*z + a[9];
+    }
+};
+
+/* Open edges are kept in place by a heavily weighted plane perpendicular
+   to the face */
+constexpr Double BoundaryWeight = 1000.0;
+
+struct Collapse {
+    Double cost;
+    UnsignedInt from, to;
+    UnsignedInt fromVersion, toVersion;
+    Vector3 position;
+
+    bool operator>(const Collapse& other) const { return cost > other.cost; }
+};
+
+class Simplifier {
+    public:
+        explicit Simplifier(const std::vector<Vector3>& positions, const std::vector<std::vector<UnsignedInt>>& vertexNormals, const std::vector<Math::Vector3<UnsignedInt>>& triangles): positions(positions), vertexNormals(vertexNormals), triangles(triangles), removed(triangles.size()), vertexTriangles(positions.size()), quadrics(positions.size()), versions(positions.size()), alive(triangles.size()) {
+            for(std::size_t i = 0; i != triangles.size(); ++i) {
+                const Math::Vector3<UnsignedInt>& t = triangles[i];
+                const Vector3 normal = Math::cross(positions[t[1]] - positions[t[0]], positions[t[2]] - positions[t[0]]);
+                const Float length = normal.length();
+                for(UnsignedInt j = 0; j != 3; ++j) {
+                    vertexTriangles[t[j]].push_back(i);
+                    if(length > 0.0f)
+                        quadrics[t[j]] += Quadric::plane(normal/length, positions[t[0]]);
+                }
+            }
+
+            /* Edges used by only one triangle */
+            std::map<std::pair<UnsignedInt, UnsignedInt>, UnsignedInt> edges;
+            for(const Math::Vector3<UnsignedInt>& t: triangles) for(UnsignedInt j = 0; j != 3; ++j)
+                ++edges[std::minmax(t[j], t[(j + 1)%3])];
+            for(const Math::Vector3<UnsignedInt>& t: triangles) {
+                const Vector3 normal = Math::cross(positions[t[1]] - positions[t[0]], positions[t[2]] - positions[t[0]]);
+                for(UnsignedInt j = 0; j != 3; ++j) {
+                    const UnsignedInt a = t[j], b = t[(j + 1)%3];
+                    if(edges[std::minmax(a, b)] != 1) continue;
+
+                    const Vector3 perpendicular = Math::cross(positions[b] - positions[a], normal);
+                    if(perpendicular.length() == 0.0f) continue;
+                    const Quadric q = Quadric::plane(perpendicular.normalized(), positions[a], BoundaryWeight);
+                    quadrics[a] += q;
+                    quadrics[b] += q;
+                }
+            }
+
+            for(const auto& edge: edges) push(edge.first.first, edge.first.second);
+        }
+
+        Float run(std::size_t targetTriangleCount, Float maxError) {
+            Float error = 0.0f;
+            while(alive > targetTriangleCount && !queue.empty()) {
+                const Collapse c = queue.top();
+                queue.pop();
+
+                /* Outdated entry */
+                if(versions[c.from] != c.fromVersion || versions[c.to] != c.toVersion)
+                    continue;
+
+                /* Everything else is worse */
+                const Float cost = Float(std::sqrt(Math::max(c.cost, 0.0)));
+                if(cost > maxError) break;
+
+                if(!isCollapsible(c)) continue;
+
+                collapse(c);
+                error = Math::max(error, cost);
+            }
+
+            return error;
+        }
+
+        std::vector<Vector3> positions;
+        std::vector<std::vector<UnsignedInt>> vertexNormals;
+        std::vector<Math::Vector3<UnsignedInt>> triangles;
+        std::vector<bool> removed;
+
+    private:
+        /* Neighbors of given vertex, in no particular order */
+        std::vector<UnsignedInt> neighbors(UnsignedInt vertex) const {
+            std::vector<UnsignedInt> out;
+            for(UnsignedInt t: vertexTriangles[vertex]) if(!removed[t])
+                for(UnsignedInt j = 0; j != 3; ++j)
+                    if(triangles[t][j] != vertex) out.push_back(triangles[t][j]);
+            std::sort(out.begin(), out.end());
+            out.erase(std::unique(out.begin(), out.end()), out.end());
+            return out;
+        }
+
+        void push(UnsignedInt a, UnsignedInt b) {
+            const Quadric q = quadrics[a] + quadrics[b];
+
+            /* Pick the best of both endpoints and the midpoint */
+            Collapse c{q.error(positions[b]), a, b, versions[a], versions[b], positions[b]};
+            const Double costA = q.error(positions[a]);
+            if(costA < c.cost) {
+                c.cost = costA;
+                c.position = positions[a];
+            }
+            const Vector3 midpoint = (positions[a] + positions[b])*0.5f;
+            const Double costMidpoint = q.error(midpoint);
+            if(costMidpoint < c.cost) {
+                c.cost = costMidpoint;
+                c.position = midpoint;
+            }
+
+            queue.push(c);
+        }
+
+        bool isCollapsible(const Collapse& c) const {
+            /* Link condition: the vertices may share only the neighbors of
+               the triangles being removed, otherwise the collapse would
+               create non-manifold geometry */
+            std::size_t shared = 0;
+            for(UnsignedInt t: vertexTriangles[c.from]) if(!removed[t])
+                if(triangles[t][0] == c.to || triangles[t][1] == c.to || triangles[t][2] == c.to) ++shared;
+            const std::vector<UnsignedInt> fromNeighbors = neighbors(c.from), toNeighbors = neighbors(c.to);
+            std::vector<UnsignedInt> common;
+            std::set_intersection(fromNeighbors.begin(), fromNeighbors.end(), toNeighbors.begin(), toNeighbors.end(), std::back_inserter(common));
+            if(common.size() != shared) return false;
+
+            /* No remaining triangle may flip or degenerate */
+            for(UnsignedInt vertex: {c.from, c.to}) for(UnsignedInt t: vertexTriangles[vertex]) {
+                if(removed[t]) continue;
+                const Math::Vector3<UnsignedInt>& tri = triangles[t];
+                if((tri[0] == c.from || tri[1] == c.from || tri[2] == c.from) &&
+                   (tri[0] == c.to || tri[1] == c.to || tri[2] == c.to)) continue;
+
+                Vector3 p[3];
+                for(UnsignedInt j = 0; j != 3; ++j)
+                    p[j] = tri[j] == c.from || tri[j] == c.to ? c.position : positions[tri[j]];
+
+                const Vector3 before = Math::cross(positions[tri[1]] - positions[tri[0]], positions[tri[2]] - positions[tri[0]]);
+                const Vector3 after = Math::cross(p[1] - p[0], p[2] - p[0]);
+                if(after.length() <= 1.0e-4f*before.length()) return false;
+                if(Math::dot(before.normalized(), after.normalized()) < 0.2f) return false;
+            }
+
+            return true;
+        }
+
+        void collapse(const Collapse& c) {
+            for(UnsignedInt t: vertexTriangles[c.from]) {
+                if(removed[t]) continue;
+                Math::Vector3<UnsignedInt>& tri = triangles[t];
+                if(tri[0] == c.to || tri[1] == c.to || tri[2] == c.to) {
+                    removed[t] = true;
+                    --alive;
+                    continue;
+                }
+
+                for(UnsignedInt j = 0; j != 3; ++j) if(tri[j] == c.from) tri[j] = c.to;
+                vertexTriangles[c.to].push_back(t);
+            }
+
+            /* Drop removed triangles from the list */
+            std::vector<UnsignedInt>& list = vertexTriangles[c.to];
+            list.erase(std::remove_if(list.begin(), list.end(), [this](UnsignedInt t) { return removed[t]; }), list.end());
+            vertexTriangles[c.from].clear();
+
+            positions[c.to] = c.position;
+            vertexNormals[c.to].insert(vertexNormals[c.to].end(), vertexNormals[c.from].begin(), vertexNormals[c.from].end());
+            quadrics[c.to] += quadrics[c.from];
+            ++versions[c.from];
+            ++versions[c.to];
+
+            for(UnsignedInt neighbor: neighbors(c.to)) push(neighbor, c.to);
+        }
+
+        std::vector<std::vector<UnsignedInt>> vertexTriangles;
+        std::vector<Quadric> quadrics;
+        std::vector<UnsignedInt> versions;
+        std::size_t alive;
+        std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> queue;
+};
+
+}
+
+MeshSimplifier::MeshSimplifier(const std::vector<Vector3>& positions, const std::vector<Vector3>& normals, const std::vector<UnsignedInt>& indices): normals(normals) {
+    CORRADE_ASSERT(positions.size() == normals.size(), "ResourceManagement::MeshSimplifier: position and normal count doesn't match", );
+    CORRADE_ASSERT(indices.size()%3 == 0, "ResourceManagement::MeshSimplifier: index count not divisible by 3", );
+
+    /* Weld vertices with the same position, remember all their normals */
+    std::map<std::tuple<Float, Float, Float>, UnsignedInt> welded;
+    std::vector<UnsignedInt> remap(positions.size());
+    for(std::size_t i = 0; i != positions.size(); ++i) {
+        const auto inserted = welded.emplace(std::make_tuple(positions[i].x(), positions[i].y(), positions[i].z()), this->positions.size());
+        if(inserted.second) {
+            this->positions.push_back(positions[i]);
+            vertexNormals.emplace_back();
+        }
+        remap[i] = inserted.first->second;
+        vertexNormals[remap[i]].push_back(i);
+    }
+
+    /* Drop triangles which became degenerate */
+    for(std::size_t i = 0; i != indices.size(); i += 3) {
+        const Math::Vector3<UnsignedInt> t{remap[indices[i]], remap[indices[i + 1]], remap[indices[i + 2]]};
+        if(t[0] != t[1] && t[1] != t[2] && t[2] != t[0]) triangles.push_back(t);
+    }
+}
+
+MeshSimplifier::Result MeshSimplifier::simplify(std::size_t targetTriangleCount, Float maxError, Deg creaseAngle) const {
+    Simplifier simplifier(positions, vertexNormals, triangles);
+
+    Result result;
+    result.error = simplifier.run(targetTriangleCount, maxError);
+
+    /* Each corner gets the original normal of its vertex closest to the
+       face normal. If none of them is close enough, faces are smoothed
+       together by the crease angle instead. */
+    const Float creaseCos = Math::cos(Rad(creaseAngle));
+    std::map<std::pair<UnsignedInt, UnsignedInt>, UnsignedInt> original;
+    std::vector<std::vector<std::pair<UnsignedInt, Vector3>>> recalculated(simplifier.positions.size());
+    std::vector<bool> isRecalculated;
+    for(std::size_t i = 0; i != simplifier.triangles.size(); ++i) {
+        if(simplifier.removed[i]) continue;
+
+        const Math::Vector3<UnsignedInt>& t = simplifier.triangles[i];
+        const Vector3 normal = Math::cross(simplifier.positions[t[1]] - simplifier.positions[t[0]], simplifier.positions[t[2]] - simplifier.positions[t[0]]);
+        const Vector3 direction = normal.normalized();
+
+        for(UnsignedInt j = 0; j != 3; ++j) {
+            const UnsignedInt vertex = t[j];
+
+            UnsignedInt closest = ~UnsignedInt{};
+            Float closestCos = creaseCos;
+            for(UnsignedInt n: simplifier.vertexNormals[vertex]) {
+                const Float cos = Math::dot(normals[n], direction);
+                if(cos >= closestCos) {
+                    closest = n;
+                    closestCos = cos;
+                }
+            }
+
+            if(closest != ~UnsignedInt{}) {
+                const auto inserted = original.emplace(std::make_pair(vertex, closest), result.positions.size());
+                if(inserted.second) {
+                    result.positions.push_back(simplifier.positions[vertex]);
+                    result.normals.push_back(normals[closest]);
+                    isRecalculated.push_back(false);
+                }
+                result.indices.push_back(inserted.first->second);
+                continue;
+            }
+
+            auto& candidates = recalculated[vertex];
+            auto found = std::find_if(candidates.begin(), candidates.end(), [&direction, creaseCos](const std::pair<UnsignedInt, Vector3>& candidate) {
+                return Math::dot(candidate.second, direction) >= creaseCos;
+            });
+
+            if(found == candidates.end()) {
+                candidates.emplace_back(result.positions.size(), direction);
+                result.positions.push_back(simplifier.positions[vertex]);
+                result.normals.emplace_back();
+                isRecalculated.push_back(true);
+                found = candidates.end() - 1;
+            }
+
+            /* Area-weighted average */
+            result.normals[found->first] += normal;
+            result.indices.push_back(found->first);
+        }
+    }
+
+    for(std::size_t i = 0; i != result.normals.size(); ++i)
+        if(isRecalculated[i]) result.normals[i] = result.normals[i].normalized();
+
+    return result;
+}
+
+}}
@@ -0,0 +1,70 @@
+#ifndef PushTheBox_ResourceManagement_MeshSimplifier_h
+#define PushTheBox_ResourceManagement_MeshSimplifier_h
+
+/** @file
+ * @brief Class PushTheBox::ResourceManagement::MeshSimplifier
+ */
+
+#include <vector>
+#include <Magnum/Math/Vector3.h>
+
+#include "PushTheBox.h"
+
+namespace PushTheBox { namespace ResourceManagement {
+
+/**
+@brief Mesh simplifier
+
+Edge collapse driven by quadric error metrics. Vertices with the same
+position are welded first, so meshes with hard edges don't fall apart along
+them. Collapses which would flip a triangle are rejected and open edges of
+the welded mesh are kept in place. The simplified mesh reuses the original
+normals where they still fit the faces, so the shading stays close to the
+original.
+*/
+class MeshSimplifier {
+    public:
+        /** @brief Simplified mesh */
+        struct Result {
+            std::vector<UnsignedInt> indices;
+            std::vector<Vector3> positions;
+            std::vector<Vector3> normals;
+            Float error;    /**< Largest error of performed collapses */
+        };
+
+        /**
+         * @brief Constructor
+         * @param positions     Vertex positions
+         * @param normals       Vertex normals
+         * @param indices       Triangle indices
+         */
+        explicit MeshSimplifier(const std::vector<Vector3>& positions, const std::vector<Vector3>& normals, const std::vector<UnsignedInt>& indices);
+
+        /** @brief Triangle count of the welded input */
+        std::size_t triangleCount() const { return triangles.size(); }
+
+        /**
+         * @brief Simplify the mesh
+         * @param targetTriangleCount   Stop when there is this many triangles
+         *      left
+         * @param maxError      Stop before a collapse which would move the
+         *      surface further than this
+         * @param creaseAngle   Original normals further than this from the
+         *      face normal are not used for the face. Faces without any
+         *      fitting original normal get a recalculated one, smoothed
+         *      with neighbor faces closer than this angle.
+         *
+         * The input is left untouched, so it's possible to call this
+         * repeatedly for different levels of detail.
+         */
+        Result simplify(std::size_t targetTriangleCount, Float maxError, Deg creaseAngle) const;
+
+    private:
+        std::vector<Vector3> positions, normals;
+        std::vector<std::vector<UnsignedInt>> vertexNormals;
+        std::vector<Math::Vector3<UnsignedInt>> triangles;
+};
+
+}}
+
+#endif
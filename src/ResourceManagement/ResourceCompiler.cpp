@@ -2,6 +2,8 @@
 
 #include <algorithm>
 #include <ostream>
+#include <string>
+#include <Corrade/Containers/ArrayView.h>
 #include <Magnum/Math/Functions.h>
 #include <Magnum/Math/Matrix4.h>
 #include <Magnum/MeshTools/CompressIndices.h>
@@ -11,6 +13,7 @@
 #include <Magnum/Trade/MeshData3D.h>
 
 #include "configure.h"
+#include "ResourceManagement/MeshSimplifier.h"
 
 namespace PushTheBox { namespace ResourceManagement {
 
@@ -21,57 +24,92 @@ ResourceCompiler::ResourceCompiler(const std::string& filename): manager(MAGNUM_
     CORRADE_ASSERT(importer->openFile(filename), "Cannot open file" << filename, );
 }
 
+namespace {
+    /* Relative triangle count and largest allowed error for each level of
+       detail, meshes with less triangles than the minimum don't get any */
+    constexpr std::size_t LodMinTriangleCount = 2000;
+    constexpr struct {
+        Float triangleRatio;
+        Float maxError;
+    } Lods[]{
+        {0.5f, 0.01f},
+        {0.25f, 0.04f}
+    };
+}
+
 void ResourceCompiler::compileMeshes(Utility::ConfigurationGroup* configuration, std::ostream& out) {
     for(std::size_t i = 0; i != importer->mesh3DCount(); ++i) {
-        Utility::ConfigurationGroup* group = configuration->addGroup("mesh");
-
         /* Import mesh */
         std::optional<Trade::MeshData3D> mesh = importer->mesh3D(i);
         CORRADE_ASSERT(mesh->normalArrayCount() == 1, "Mesh" << importer->mesh3DName(i) << "has no normal array", );
 
-        group->addValue("name", importer->mesh3DName(i));
-        group->addValue("primitive", mesh->primitive());
+        /* Rotate to have Y up */
+        /** @todo Fix this in Collada importer itself */
+        auto rotation = Quaternion::rotation(-90.0_degf, Vector3::xAxis());
+        MeshTools::transformVectorsInPlace(rotation, mesh->normals(0));
+        MeshTools::transformVectorsInPlace(rotation, mesh->positions(0));
+
+        const std::string name = importer->mesh3DName(i);
+        std::vector<UnsignedInt> indices;
+        if(mesh->isIndexed()) indices = mesh->indices();
+        compileMesh(configuration->addGroup("mesh"), name, mesh->primitive(), indices, mesh->positions(0), mesh->normals(0), out);
 
-        /* Compile index array, if present */
-        if(mesh->isIndexed()) {
-            /* Optimize indices */
-            MeshTools::tipsify(mesh->indices(), mesh->positions(0).size(), 24);
+        /* Simplified versions of large meshes, named `<name>-lod1` etc. */
+        if(mesh->primitive() != MeshPrimitive::Triangles || indices.size()/3 < LodMinTriangleCount)
+            continue;
 
-            Containers::Array<char> indexData;
-            Mesh::IndexType indexType;
-            UnsignedInt indexStart, indexEnd;
-            std::tie(indexData, indexType, indexStart, indexEnd) = MeshTools::compressIndices(mesh->indices());
+        MeshSimplifier simplifier(mesh->positions(0), mesh->normals(0), mesh->indices());
+        std::size_t previousIndexCount = indices.size();
+        for(std::size_t lod = 0; lod != Containers::arraySize(Lods); ++lod) {
+            MeshSimplifier::Result result = simplifier.simplify(std::size_t(simplifier.triangleCount()*Lods[lod].triangleRatio), Lods[lod].maxError, 60.0_degf);
 
-            group->addValue("indexOffset", std::size_t(out.tellp()));
-            group->addValue("indexCount", mesh->indices().size());
-            group->addValue("indexType", indexType);
-            group->addValue("indexStart", indexStart);
-            group->addValue("indexEnd", indexEnd);
+            /* Not worth it anymore */
+            if(result.indices.size() > previousIndexCount*3/4) break;
+            previousIndexCount = result.indices.size();
 
-            out.write(indexData, indexData.size());
+            Debug() << "Mesh" << name << "LOD" << lod + 1 << "has" << result.indices.size()/3 << "triangles, error" << result.error;
+            compileMesh(configuration->addGroup("mesh"), name + "-lod" + std::to_string(lod + 1), MeshPrimitive::Triangles, result.indices, result.positions, result.normals, out);
         }
+    }
+}
 
-        /* Rotate to have Y up */
-        /** @todo Fix this in Collada importer itself */
-        auto rotation = Quaternion::rotation(-90.0_degf, Vector3::xAxis());
-        MeshTools::transformVectorsInPlace(rotation, mesh->normals(0));
-        MeshTools::transformVectorsInPlace(rotation, mesh->positions(0));
+void ResourceCompiler::compileMesh(Utility::ConfigurationGroup* group, const std::string& name, MeshPrimitive primitive, std::vector<UnsignedInt>& indices, const std::vector<Vector3>& positions, const std::vector<Vector3>& normals, std::ostream& out) {
+    group->addValue("name", name);
+    group->addValue("primitive", primitive);
 
-        /* Compress normals */
-        std::vector<Math::Vector3<Byte>> normals(mesh->normals(0).size());
-        std::transform(mesh->normals(0).begin(), mesh->normals(0).end(), normals.begin(),
-                       [](const Vector3& vec) { return Math::pack<Math::Vector3<Byte>>(vec); });
+    /* Compile index array, if present */
+    if(!indices.empty()) {
+        /* Optimize indices */
+        MeshTools::tipsify(indices, positions.size(), 24);
 
-        /* Compile vertex array */
-        const Containers::Array<char> data = MeshTools::interleave(mesh->positions(0), normals, 1);
+        Containers::Array<char> indexData;
+        Mesh::IndexType indexType;
+        UnsignedInt indexStart, indexEnd;
+        std::tie(indexData, indexType, indexStart, indexEnd) = MeshTools::compressIndices(indices);
 
-        group->addValue("vertexArray", "3D interleaved position normal");
-        group->addValue("vertexOffset", std::size_t(out.tellp()));
-        group->addValue("vertexCount", mesh->positions(0).size());
-        group->addValue("vertexStride", sizeof(Vector3) + sizeof(Math::Vector3<Byte>) + 1);
+        group->addValue("indexOffset", std::size_t(out.tellp()));
+        group->addValue("indexCount", indices.size());
+        group->addValue("indexType", indexType);
+        group->addValue("indexStart", indexStart);
+        group->addValue("indexEnd", indexEnd);
 
-        out.write(data, data.size());
+        out.write(indexData, indexData.size());
     }
+
+    /* Compress normals */
+    std::vector<Math::Vector3<Byte>> packedNormals(normals.size());
+    std::transform(normals.begin(), normals.end(), packedNormals.begin(),
+                   [](const Vector3& vec) { return Math::pack<Math::Vector3<Byte>>(vec); });
+
+    /* Compile vertex array */
+    const Containers::Array<char> data = MeshTools::interleave(positions, packedNormals, 1);
+
+    group->addValue("vertexArray", "3D interleaved position normal");
+    group->addValue("vertexOffset", std::size_t(out.tellp()));
+    group->addValue("vertexCount", positions.size());
+    group->addValue("vertexStride", sizeof(Vector3) + sizeof(Math::Vector3<Byte>) + 1);
+
+    out.write(data, data.size());
 }
 
 }}
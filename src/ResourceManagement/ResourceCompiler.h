@@ -2,6 +2,7 @@
 #define PushTheBox_ResourceManagement_ResourceCompiler_h
 
 #include <iosfwd>
+#include <vector>
 #include <Corrade/PluginManager/Manager.h>
 #include <Magnum/Trade/AbstractImporter.h>
 
@@ -20,6 +21,8 @@ class ResourceCompiler {
         void compileMeshes(Utility::ConfigurationGroup* configuration, std::ostream& out);
 
     private:
+        void compileMesh(Utility::ConfigurationGroup* group, const std::string& name, MeshPrimitive primitive, std::vector<UnsignedInt>& indices, const std::vector<Vector3>& positions, const std::vector<Vector3>& normals, std::ostream& out);
+
         PluginManager::Manager<Trade::AbstractImporter> manager;
         std::unique_ptr<Trade::AbstractImporter> importer;
 };
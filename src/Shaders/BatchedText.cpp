@@ -0,0 +1,68 @@
+#include "BatchedText.h"
+
+#include <Corrade/Utility/Assert.h>
+#include <Corrade/Utility/Resource.h>
+#include <Magnum/Context.h>
+#include <Magnum/Extensions.h>
+#include <Magnum/Shader.h>
+#include <Magnum/Texture.h>
+
+namespace PushTheBox { namespace Shaders {
+
+namespace {
+    enum: Int {
+        TextureLayer = 16,
+    };
+}
+
+BatchedText::BatchedText() {
+    Utility::Resource mr("MagnumShaders");
+    Utility::Resource rs("PushTheBoxShaders");
+
+    #ifndef MAGNUM_TARGET_GLES
+    const Version v = Context::current().supportedVersion({Version::GL320, Version::GL210});
+    #else
+    const Version v = Context::current().supportedVersion({Version::GLES300, Version::GLES200});
+    #endif
+
+    Shader vert(v, Shader::Type::Vertex);
+    Shader frag(v, Shader::Type::Fragment);
+
+    vert.addSource(mr.get("compatibility.glsl"))
+        .addSource(rs.get("BatchedText.vert"));
+    frag.addSource(mr.get("compatibility.glsl"))
+        .addSource(rs.get("BatchedText.frag"));
+
+    CORRADE_INTERNAL_ASSERT_OUTPUT(Shader::compile({vert, frag}));
+
+    attachShaders({vert, frag});
+
+    bindAttributeLocation(Position::Location, "position");
+    bindAttributeLocation(TextureCoordinates::Location, "textureCoordinates");
+    bindAttributeLocation(Transformation::Location, "transformation");
+    bindAttributeLocation(Color::Location, "color");
+
+    CORRADE_INTERNAL_ASSERT_OUTPUT(link());
+
+    projectionMatrixUniform = uniformLocation("projectionMatrix");
+    outlineColorUniform = uniformLocation("outlineColor");
+    outlineRangeUniform = uniformLocation("outlineRange");
+
+    #ifndef MAGNUM_TARGET_GLES
+    if(!Context::current().isExtensionSupported<Extensions::GL::ARB::shading_language_420pack>())
+    #endif
+    {
+        setUniform(uniformLocation("textureData"), TextureLayer);
+    }
+
+    /* Same defaults as in Magnum's DistanceFieldVector */
+    setUniform(uniformLocation("smoothness"), 0.04f);
+    setOutlineRange(0.5f, 1.0f);
+}
+
+BatchedText& BatchedText::setVectorTexture(Texture2D& texture) {
+    texture.bind(TextureLayer);
+    return *this;
+}
+
+}}
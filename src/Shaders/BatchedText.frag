@@ -0,0 +1,36 @@
+#ifndef NEW_GLSL
+#define in varying
+#define fragmentColor gl_FragColor
+#define texture texture2D
+#endif
+
+#ifdef EXPLICIT_TEXTURE_LAYER
+layout(binding = 16) uniform sampler2D textureData;
+#else
+uniform sampler2D textureData;
+#endif
+
+uniform lowp vec4 outlineColor;
+uniform lowp vec2 outlineRange;
+uniform lowp float smoothness;
+
+in mediump vec2 interpolatedTextureCoordinates;
+in lowp vec3 interpolatedColor;
+
+#ifdef NEW_GLSL
+out lowp vec4 fragmentColor;
+#endif
+
+void main() {
+    lowp float intensity = texture(textureData, interpolatedTextureCoordinates).r;
+
+    /* Fill */
+    fragmentColor = smoothstep(outlineRange.x - smoothness, outlineRange.x + smoothness, intensity)*vec4(interpolatedColor, 1.0);
+
+    /* Outline */
+    if(outlineRange.x > outlineRange.y) {
+        lowp float mid = (outlineRange.x + outlineRange.y)/2.0;
+        lowp float halfRange = (outlineRange.x - outlineRange.y)/2.0;
+        fragmentColor += smoothstep(halfRange + smoothness, halfRange - smoothness, distance(mid, intensity))*outlineColor;
+    }
+}
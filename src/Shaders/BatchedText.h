@@ -0,0 +1,75 @@
+#ifndef PushTheBox_Shaders_BatchedText_h
+#define PushTheBox_Shaders_BatchedText_h
+
+/** @file
+ * @brief Class PushTheBox::Shaders::BatchedText
+ */
+
+#include <Magnum/AbstractShaderProgram.h>
+#include <Magnum/Color.h>
+#include <Magnum/Math/Matrix3.h>
+
+#include "PushTheBox.h"
+
+namespace PushTheBox { namespace Shaders {
+
+/**
+@brief Batched distance field text shader
+
+Same rendering as @magnumref{Shaders::DistanceFieldVector2D}, but the
+transformation and fill color are vertex attributes instead of uniforms, so
+many texts with different placement and color can be drawn in a single call.
+Only translation and uniform scaling is supported, which is all the 2D scene
+graph can do anyway. Outline is common for all texts.
+*/
+class BatchedText: public AbstractShaderProgram {
+    public:
+        /** @brief Vertex position, relative to the text origin */
+        typedef Attribute<0, Vector2> Position;
+
+        /** @brief Glyph texture coordinates */
+        typedef Attribute<1, Vector2> TextureCoordinates;
+
+        /** @brief Text translation in XY, scale in Z */
+        typedef Attribute<2, Vector3> Transformation;
+
+        /** @brief Fill color */
+        typedef Attribute<3, Color3> Color;
+
+        explicit BatchedText();
+
+        /** @brief Set projection matrix */
+        BatchedText& setProjectionMatrix(const Matrix3& matrix) {
+            setUniform(projectionMatrixUniform, matrix);
+            return *this;
+        }
+
+        /** @brief Set outline color */
+        BatchedText& setOutlineColor(const Color4& color) {
+            setUniform(outlineColorUniform, color);
+            return *this;
+        }
+
+        /**
+         * @brief Set outline range
+         *
+         * Same meaning as in @magnumref{Shaders::DistanceFieldVector2D}, if
+         * @p start is not larger than @p end, there is no outline.
+         */
+        BatchedText& setOutlineRange(Float start, Float end) {
+            setUniform(outlineRangeUniform, Vector2(start, end));
+            return *this;
+        }
+
+        /** @brief Set glyph cache texture */
+        BatchedText& setVectorTexture(Texture2D& texture);
+
+    private:
+        Int projectionMatrixUniform,
+            outlineColorUniform,
+            outlineRangeUniform;
+};
+
+}}
+
+#endif
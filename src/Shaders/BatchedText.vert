@@ -0,0 +1,22 @@
+#ifndef NEW_GLSL
+#define in attribute
+#define out varying
+#endif
+
+uniform highp mat3 projectionMatrix;
+
+in highp vec2 position;
+in mediump vec2 textureCoordinates;
+in highp vec3 transformation;
+in lowp vec3 color;
+
+out mediump vec2 interpolatedTextureCoordinates;
+out lowp vec3 interpolatedColor;
+
+void main() {
+    /* Translation in XY, uniform scale in Z */
+    gl_Position.xywz = vec4(projectionMatrix*vec3(position*transformation.z + transformation.xy, 1.0), 0.0);
+
+    interpolatedTextureCoordinates = textureCoordinates;
+    interpolatedColor = color;
+}
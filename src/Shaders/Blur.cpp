@@ -1,5 +1,6 @@
 #include "Blur.h"
 
+#include <sstream>
 #include <Corrade/Utility/Assert.h>
 #include <Corrade/Utility/Resource.h>
 #include <Magnum/Context.h>
@@ -14,9 +15,77 @@ namespace {
     enum: Int {
         TextureLayer = 16,
     };
+
+    /* Binomial coefficients approximate the Gaussian and are exact, so the
+       whole kernel can be computed at compile time. Row `n` has standard
+       deviation of sqrt(n)/2, the outermost `trim` taps on each side are
+       dropped as they contribute next to nothing. */
+    constexpr Double binomial(UnsignedInt n, UnsignedInt k) {
+        return k == 0 ? 1.0 : binomial(n, k - 1)*(n - k + 1)/k;
+    }
+
+    constexpr UnsignedInt sideTapCount(UnsignedInt n, UnsignedInt trim) {
+        return n/2 - trim;
+    }
+
+    constexpr Double sideSum(UnsignedInt n, UnsignedInt i, UnsignedInt last) {
+        return i > last ? 0.0 : binomial(n, n/2 + i) + sideSum(n, i + 1, last);
+    }
+
+    /* Weight of tap `i` away from the center, zero outside of the kernel */
+    constexpr Double tapWeight(UnsignedInt n, UnsignedInt trim, UnsignedInt i) {
+        return i > sideTapCount(n, trim) ? 0.0 :
+            binomial(n, n/2 + i)/(binomial(n, n/2) + 2.0*sideSum(n, 1, sideTapCount(n, trim)));
+    }
+
+    /* Taps 2i - 1 and 2i are merged into one bilinear fetch placed at their
+       weighted center */
+    constexpr Float sampleWeight(UnsignedInt n, UnsignedInt trim, UnsignedInt i) {
+        return Float(tapWeight(n, trim, 2*i - 1) + tapWeight(n, trim, 2*i));
+    }
+
+    constexpr Float sampleOffset(UnsignedInt n, UnsignedInt trim, UnsignedInt i) {
+        return sampleWeight(n, trim, i) == 0.0f ? 0.0f :
+            Float(((2*i - 1)*tapWeight(n, trim, 2*i - 1) + 2*i*tapWeight(n, trim, 2*i))/
+                (tapWeight(n, trim, 2*i - 1) + tapWeight(n, trim, 2*i)));
+    }
+
+    /* At most four fetches on each side, so they fit into a vec4 */
+    struct Kernel {
+        UnsignedInt sampleCount;
+        Float centerWeight;
+        Float offsets[4];
+        Float weights[4];
+    };
+
+    constexpr Kernel kernel(UnsignedInt n, UnsignedInt trim) {
+        return {(sideTapCount(n, trim) + 1)/2, Float(tapWeight(n, trim, 0)),
+            {sampleOffset(n, trim, 1), sampleOffset(n, trim, 2), sampleOffset(n, trim, 3), sampleOffset(n, trim, 4)},
+            {sampleWeight(n, trim, 1), sampleWeight(n, trim, 2), sampleWeight(n, trim, 3), sampleWeight(n, trim, 4)}};
+    }
+
+    /* Indexed with Blur::Quality */
+    constexpr Kernel Kernels[]{
+        kernel(6, 0),
+        kernel(16, 2),
+        kernel(24, 5)
+    };
+
+    static_assert(Kernels[0].sampleCount == 2 && Kernels[1].sampleCount == 3 && Kernels[2].sampleCount == 4, "unexpected blur kernel size");
+
+    std::string kernelSource(const Kernel& kernel) {
+        std::ostringstream out;
+        out.precision(8);
+        out << std::fixed
+            << "#define BLUR_SAMPLE_COUNT " << kernel.sampleCount << "\n"
+            << "#define BLUR_CENTER_WEIGHT " << kernel.centerWeight << "\n"
+            << "#define BLUR_OFFSETS vec4(" << kernel.offsets[0] << ", " << kernel.offsets[1] << ", " << kernel.offsets[2] << ", " << kernel.offsets[3] << ")\n"
+            << "#define BLUR_WEIGHTS vec4(" << kernel.weights[0] << ", " << kernel.weights[1] << ", " << kernel.weights[2] << ", " << kernel.weights[3] << ")\n";
+        return out.str();
+    }
 }
 
-Blur::Blur(Direction direction) {
+Blur::Blur(Direction direction, Quality quality) {
     Utility::Resource mr("MagnumShaders");
     Utility::Resource rs("PushTheBoxShaders");
 
@@ -29,11 +98,14 @@ Blur::Blur(Direction direction) {
     Shader vert(v, Shader::Type::Vertex);
     Shader frag(v, Shader::Type::Fragment);
 
+    const std::string kernel = kernelSource(Kernels[UnsignedByte(quality)]);
     vert.addSource(direction == Direction::Horizontal ? "#define DIRECTION_HORIZONTAL\n" : "")
+        .addSource(kernel)
         .addSource(mr.get("compatibility.glsl"))
         .addSource(mr.get("FullScreenTriangle.glsl"))
         .addSource(rs.get("Blur.vert"));
-    frag.addSource(mr.get("compatibility.glsl"))
+    frag.addSource(kernel)
+        .addSource(mr.get("compatibility.glsl"))
         .addSource(rs.get("Blur.frag"));
 
     CORRADE_INTERNAL_ASSERT_OUTPUT(Shader::compile({vert, frag}));
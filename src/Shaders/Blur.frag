@@ -11,27 +11,17 @@ uniform sampler2D textureData;
 #endif
 
 in mediump vec2 textureCoords;
-in mediump vec4 blurTextureCoords[7];
+in mediump vec4 blurTextureCoords[BLUR_SAMPLE_COUNT];
 
 #ifdef NEW_GLSL
 out mediump vec4 fragmentColor;
 #endif
 
 void main() {
-    fragmentColor  = vec4(0.0);
-    fragmentColor += texture(textureData, blurTextureCoords[6].xy)*0.0044299121055113265;
-    fragmentColor += texture(textureData, blurTextureCoords[5].xy)*0.00895781211794;
-    fragmentColor += texture(textureData, blurTextureCoords[4].xy)*0.0215963866053;
-    fragmentColor += texture(textureData, blurTextureCoords[3].xy)*0.0443683338718;
-    fragmentColor += texture(textureData, blurTextureCoords[2].xy)*0.0776744219933;
-    fragmentColor += texture(textureData, blurTextureCoords[1].xy)*0.115876621105;
-    fragmentColor += texture(textureData, blurTextureCoords[0].xy)*0.147308056121;
-    fragmentColor += texture(textureData, textureCoords          )*0.159576912161;
-    fragmentColor += texture(textureData, blurTextureCoords[0].zw)*0.147308056121;
-    fragmentColor += texture(textureData, blurTextureCoords[1].zw)*0.115876621105;
-    fragmentColor += texture(textureData, blurTextureCoords[2].zw)*0.0776744219933;
-    fragmentColor += texture(textureData, blurTextureCoords[3].zw)*0.0443683338718;
-    fragmentColor += texture(textureData, blurTextureCoords[4].zw)*0.0215963866053;
-    fragmentColor += texture(textureData, blurTextureCoords[5].zw)*0.00895781211794;
-    fragmentColor += texture(textureData, blurTextureCoords[6].zw)*0.0044299121055113265;
+    mediump vec4 weights = BLUR_WEIGHTS;
+    fragmentColor = texture(textureData, textureCoords)*BLUR_CENTER_WEIGHT;
+    for(int i = 0; i != BLUR_SAMPLE_COUNT; ++i) {
+        fragmentColor += texture(textureData, blurTextureCoords[i].xy)*weights[i];
+        fragmentColor += texture(textureData, blurTextureCoords[i].zw)*weights[i];
+    }
 }
@@ -16,7 +16,19 @@ class Blur: public AbstractShaderProgram {
             Vertical
         };
 
-        explicit Blur(Direction direction);
+        /**
+         * @brief Quality
+         *
+         * Each tier is a binomial approximation of a Gaussian kernel, with
+         * neighboring taps merged into a single bilinear fetch.
+         */
+        enum class Quality: UnsignedByte {
+            Low,    /**< 7 taps in 5 fetches */
+            Medium, /**< 13 taps in 7 fetches */
+            High    /**< 15 taps in 9 fetches */
+        };
+
+        explicit Blur(Direction direction, Quality quality = Quality::High);
 
         Blur& setImageSizeInverted(const Vector2& size);
 
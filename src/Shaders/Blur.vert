@@ -17,7 +17,7 @@ uniform vec2 imageSizeInverted;
 #endif
 
 out mediump vec2 textureCoords;
-out mediump vec4 blurTextureCoords[7];
+out mediump vec4 blurTextureCoords[BLUR_SAMPLE_COUNT];
 
 mediump vec2 coordinate(mediump float value) {
     #ifdef DIRECTION_HORIZONTAL
@@ -46,8 +46,11 @@ void main() {
     #endif
     #endif
 
-    for(int i = 0; i != 7; ++i) {
-        blurTextureCoords[i].xy = textureCoords - coordinate(increment*float(i+1));
-        blurTextureCoords[i].zw = textureCoords + coordinate(increment*float(i+1));
+    /* Each fetch lies between two texels, so bilinear filtering blends them
+       in the right ratio */
+    mediump vec4 offsets = BLUR_OFFSETS;
+    for(int i = 0; i != BLUR_SAMPLE_COUNT; ++i) {
+        blurTextureCoords[i].xy = textureCoords - coordinate(increment*offsets[i]);
+        blurTextureCoords[i].zw = textureCoords + coordinate(increment*offsets[i]);
     }
 }
@@ -0,0 +1,111 @@
+#include "CachedPhong.h"
+
+#include <cstring>
+#include <Corrade/Utility/Assert.h>
+#include <Corrade/Utility/Resource.h>
+#include <Magnum/Context.h>
+#include <Magnum/Shader.h>
+
+#include "Shaders/FrameUniforms.h"
+
+namespace PushTheBox { namespace Shaders {
+
+CachedPhong::CachedPhong(): projectionMatrixUniform(-1), lightPositionUniform(-1), ambientColorUniform(-1), specularColorUniform(-1), valid(0), _uploadCount(0) {
+    Utility::Resource mr("MagnumShaders");
+    Utility::Resource rs("PushTheBoxShaders");
+
+    #ifndef MAGNUM_TARGET_GLES
+    const Version v = Context::current().supportedVersion({Version::GL320, Version::GL210});
+    #else
+    const Version v = Context::current().supportedVersion({Version::GLES300, Version::GLES200});
+    #endif
+
+    Shader vert(v, Shader::Type::Vertex);
+    Shader frag(v, Shader::Type::Fragment);
+
+    vert.addSource(FrameUniforms::shaderDefines())
+        .addSource(mr.get("compatibility.glsl"))
+        .addSource(rs.get("FrameUniforms.glsl"))
+        .addSource(rs.get("Phong.vert"));
+    frag.addSource(FrameUniforms::shaderDefines())
+        .addSource(mr.get("compatibility.glsl"))
+        .addSource(rs.get("FrameUniforms.glsl"))
+        .addSource(rs.get("Phong.frag"));
+
+    CORRADE_INTERNAL_ASSERT_OUTPUT(Shader::compile({vert, frag}));
+
+    attachShaders({vert, frag});
+
+    bindAttributeLocation(Position::Location, "position");
+    bindAttributeLocation(Normal::Location, "normal");
+
+    CORRADE_INTERNAL_ASSERT_OUTPUT(link());
+
+    transformationMatrixUniform = uniformLocation("transformationMatrix");
+    normalMatrixUniform = uniformLocation("normalMatrix");
+    diffuseColorUniform = uniformLocation("diffuseColor");
+    if(FrameUniforms::isSupported()) FrameUniforms::setupShader(*this);
+    else {
+        projectionMatrixUniform = uniformLocation("projectionMatrix");
+        lightPositionUniform = uniformLocation("lightPosition");
+        ambientColorUniform = uniformLocation("ambientColor");
+        specularColorUniform = uniformLocation("specularColor");
+    }
+
+    /* Same default as Magnum's Phong */
+    setUniform(uniformLocation("shininess"), 80.0f);
+}
+
+template<class T> bool CachedPhong::update(T& cached, const T& value, UnsignedByte flag) {
+    /* Math comparison operators are fuzzy, we need exact match */
+    if((valid & flag) && std::memcmp(cached.data(), value.data(), sizeof(T)) == 0)
+        return false;
+
+    cached = value;
+    valid |= flag;
+    ++_uploadCount;
+    return true;
+}
+
+CachedPhong& CachedPhong::setTransformation(const Matrix4& matrix) {
+    if(update(transformationMatrix, matrix, TransformationValid)) {
+        setUniform(transformationMatrixUniform, matrix);
+        /** @todo rotationNormalized() when precision problems are fixed */
+        setUniform(normalMatrixUniform, matrix.rotationScaling());
+        ++_uploadCount;
+    }
+
+    return *this;
+}
+
+CachedPhong& CachedPhong::setProjectionMatrix(const Matrix4& matrix) {
+    if(update(projectionMatrix, matrix, ProjectionValid))
+        setUniform(projectionMatrixUniform, matrix);
+    return *this;
+}
+
+CachedPhong& CachedPhong::setLightPosition(const Vector3& light) {
+    if(update(lightPosition, light, LightPositionValid))
+        setUniform(lightPositionUniform, light);
+    return *this;
+}
+
+CachedPhong& CachedPhong::setAmbientColor(const Color3& color) {
+    if(update(ambientColor, color, AmbientColorValid))
+        setUniform(ambientColorUniform, color);
+    return *this;
+}
+
+CachedPhong& CachedPhong::setDiffuseColor(const Color3& color) {
+    if(update(diffuseColor, color, DiffuseColorValid))
+        setUniform(diffuseColorUniform, color);
+    return *this;
+}
+
+CachedPhong& CachedPhong::setSpecularColor(const Color3& color) {
+    if(update(specularColor, color, SpecularColorValid))
+        setUniform(specularColorUniform, color);
+    return *this;
+}
+
+}}
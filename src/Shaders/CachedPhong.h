@@ -0,0 +1,92 @@
+#ifndef PushTheBox_Shaders_CachedPhong_h
+#define PushTheBox_Shaders_CachedPhong_h
+
+/** @file
+ * @brief Class PushTheBox::Shaders::CachedPhong
+ */
+
+#include <Magnum/AbstractShaderProgram.h>
+#include <Magnum/Color.h>
+#include <Magnum/Math/Matrix4.h>
+
+#include "PushTheBox.h"
+
+namespace PushTheBox { namespace Shaders {
+
+/**
+@brief Phong shader with uniform cache
+
+Same lighting and vertex attribute locations as @magnumref{Shaders::Phong},
+sharing the sources with @ref InstancedPhong. Remembers the last value uploaded
+to each uniform and skips the upload if it is set to the same value again, so
+the drawables can set everything they need without tracking what was set before
+them. The values are compared bit by bit, so the upload is never skipped for a
+value which differs even slightly. The normal matrix is derived from the
+transformation in @ref setTransformation() and computed only if the
+transformation changed.
+
+If @ref FrameUniforms are supported, projection, light position, ambient
+and specular color are taken from there and the corresponding setters have
+no effect.
+*/
+class CachedPhong: public AbstractShaderProgram {
+    public:
+        /** @brief Vertex position */
+        typedef Attribute<0, Vector3> Position;
+
+        /** @brief Normal direction */
+        typedef Attribute<2, Vector3> Normal;
+
+        explicit CachedPhong();
+
+        /** @brief Count of uniform uploads since construction */
+        inline UnsignedInt uploadCount() const { return _uploadCount; }
+
+        /** @brief Set transformation matrix and normal matrix from it */
+        CachedPhong& setTransformation(const Matrix4& matrix);
+
+        /** @brief Set projection matrix */
+        CachedPhong& setProjectionMatrix(const Matrix4& matrix);
+
+        /** @brief Set light position in camera space */
+        CachedPhong& setLightPosition(const Vector3& light);
+
+        /** @brief Set ambient color */
+        CachedPhong& setAmbientColor(const Color3& color);
+
+        /** @brief Set diffuse color */
+        CachedPhong& setDiffuseColor(const Color3& color);
+
+        /** @brief Set specular color */
+        CachedPhong& setSpecularColor(const Color3& color);
+
+    private:
+        enum: UnsignedByte {
+            TransformationValid = 1 << 0,
+            ProjectionValid = 1 << 1,
+            LightPositionValid = 1 << 2,
+            AmbientColorValid = 1 << 3,
+            DiffuseColorValid = 1 << 4,
+            SpecularColorValid = 1 << 5
+        };
+
+        template<class T> bool update(T& cached, const T& value, UnsignedByte flag);
+
+        Int transformationMatrixUniform,
+            projectionMatrixUniform,
+            normalMatrixUniform,
+            lightPositionUniform,
+            ambientColorUniform,
+            diffuseColorUniform,
+            specularColorUniform;
+
+        UnsignedByte valid;
+        UnsignedInt _uploadCount;
+        Matrix4 transformationMatrix, projectionMatrix;
+        Vector3 lightPosition;
+        Color3 ambientColor, diffuseColor, specularColor;
+};
+
+}}
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef NEW_GLSL
+#define in varying
+#define fragmentColor gl_FragColor
+#define texture texture2D
+#endif
+
+#ifdef EXPLICIT_TEXTURE_LAYER
+layout(binding = 16) uniform sampler2D textureData;
+#else
+uniform sampler2D textureData;
+#endif
+
+#ifdef UPSAMPLE
+#define TAP_COUNT 4
+#else
+#define TAP_COUNT 2
+#endif
+
+in mediump vec2 textureCoords;
+in mediump vec4 blurTextureCoords[TAP_COUNT];
+
+#ifdef NEW_GLSL
+out mediump vec4 fragmentColor;
+#endif
+
+void main() {
+    #ifdef UPSAMPLE
+    fragmentColor  = texture(textureData, blurTextureCoords[0].xy)*(2.0/12.0);
+    fragmentColor += texture(textureData, blurTextureCoords[0].zw)*(2.0/12.0);
+    fragmentColor += texture(textureData, blurTextureCoords[1].xy)*(2.0/12.0);
+    fragmentColor += texture(textureData, blurTextureCoords[1].zw)*(2.0/12.0);
+    fragmentColor += texture(textureData, blurTextureCoords[2].xy)*(1.0/12.0);
+    fragmentColor += texture(textureData, blurTextureCoords[2].zw)*(1.0/12.0);
+    fragmentColor += texture(textureData, blurTextureCoords[3].xy)*(1.0/12.0);
+    fragmentColor += texture(textureData, blurTextureCoords[3].zw)*(1.0/12.0);
+    #else
+    fragmentColor  = texture(textureData, textureCoords          )*(4.0/8.0);
+    fragmentColor += texture(textureData, blurTextureCoords[0].xy)*(1.0/8.0);
+    fragmentColor += texture(textureData, blurTextureCoords[0].zw)*(1.0/8.0);
+    fragmentColor += texture(textureData, blurTextureCoords[1].xy)*(1.0/8.0);
+    fragmentColor += texture(textureData, blurTextureCoords[1].zw)*(1.0/8.0);
+    #endif
+}
@@ -0,0 +1,52 @@
+#ifndef PushTheBox_Shaders_DualFilterBlur_h
+#define PushTheBox_Shaders_DualFilterBlur_h
+
+/** @file
+ * @brief Class PushTheBox::Shaders::DualFilterBlur
+ */
+
+#include <Magnum/AbstractShaderProgram.h>
+
+#include "PushTheBox.h"
+
+namespace PushTheBox { namespace Shaders {
+
+/**
+@brief Dual filter blur shader
+
+One step of a downsample/upsample blur pyramid. Each pass renders into a
+framebuffer half or twice the size of the source texture and takes bilinear
+taps half a texel apart, thus averaging sixteen texels with five fetches when
+downsampling and eight fetches when upsampling. The source texture needs
+linear filtering for both minification and magnification.
+*/
+class DualFilterBlur: public AbstractShaderProgram {
+    public:
+        /** @brief Vertex position, used only on GLSL without `gl_VertexID` */
+        typedef Attribute<0, Vector2> Position;
+
+        /** @brief Pass */
+        enum class Pass: UnsignedByte {
+            Downsample, /**< Into framebuffer half the size */
+            Upsample    /**< Into framebuffer twice the size */
+        };
+
+        explicit DualFilterBlur(Pass pass);
+
+        /**
+         * @brief Set inverted size of the source texture
+         *
+         * Needed only on GLSL without `textureSize()`.
+         */
+        DualFilterBlur& setImageSizeInverted(const Vector2& size);
+
+        /** @brief Set source texture */
+        DualFilterBlur& setTexture(Texture2D& texture);
+
+    private:
+        Int imageSizeInvertedUniform;
+};
+
+}}
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef NEW_GLSL
+#define out varying
+#endif
+
+#ifdef NEW_GLSL
+#ifdef EXPLICIT_TEXTURE_LAYER
+layout(binding = 16) uniform sampler2D textureData;
+#else
+uniform sampler2D textureData;
+#endif
+#else
+uniform vec2 imageSizeInverted;
+#endif
+
+#ifdef UPSAMPLE
+#define TAP_COUNT 4
+#else
+#define TAP_COUNT 2
+#endif
+
+out mediump vec2 textureCoords;
+out mediump vec4 blurTextureCoords[TAP_COUNT];
+
+void main() {
+    fullScreenTriangle();
+
+    textureCoords = gl_Position.xy*0.5 + vec2(0.5);
+
+    #ifdef NEW_GLSL
+    mediump vec2 halfPixel = 0.5/vec2(textureSize(textureData, 0));
+    #else
+    mediump vec2 halfPixel = 0.5*imageSizeInverted;
+    #endif
+
+    /* Diagonal neighbors, shared by both passes */
+    blurTextureCoords[0].xy = textureCoords + vec2(-halfPixel.x, -halfPixel.y);
+    blurTextureCoords[0].zw = textureCoords + vec2( halfPixel.x,  halfPixel.y);
+    blurTextureCoords[1].xy = textureCoords + vec2(-halfPixel.x,  halfPixel.y);
+    blurTextureCoords[1].zw = textureCoords + vec2( halfPixel.x, -halfPixel.y);
+
+    /* Axis-aligned neighbors a texel apart when upsampling */
+    #ifdef UPSAMPLE
+    blurTextureCoords[2].xy = textureCoords + vec2(-2.0*halfPixel.x, 0.0);
+    blurTextureCoords[2].zw = textureCoords + vec2( 2.0*halfPixel.x, 0.0);
+    blurTextureCoords[3].xy = textureCoords + vec2(0.0, -2.0*halfPixel.y);
+    blurTextureCoords[3].zw = textureCoords + vec2(0.0,  2.0*halfPixel.y);
+    #endif
+}
@@ -0,0 +1,64 @@
+#include "FrameUniforms.h"
+
+#include <cstring>
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Utility/Assert.h>
+#include <Magnum/AbstractShaderProgram.h>
+#include <Magnum/Context.h>
+#include <Magnum/Extensions.h>
+#include <Magnum/OpenGL.h>
+
+namespace PushTheBox { namespace Shaders {
+
+bool FrameUniforms::isSupported() {
+    #ifndef MAGNUM_TARGET_GLES
+    return Context::current().isVersionSupported(Version::GL320) &&
+           Context::current().isExtensionSupported<Extensions::GL::ARB::uniform_buffer_object>();
+    #elif !defined(MAGNUM_TARGET_GLES2)
+    return true;
+    #else
+    return false;
+    #endif
+}
+
+std::string FrameUniforms::shaderDefines() {
+    return isSupported() ? "#define UNIFORM_BUFFERS\n" : "";
+}
+
+void FrameUniforms::setupShader(AbstractShaderProgram& shader) {
+    #ifndef MAGNUM_TARGET_GLES2
+    if(!isSupported()) return;
+
+    const GLuint index = glGetUniformBlockIndex(shader.id(), "Frame");
+    CORRADE_INTERNAL_ASSERT(index != GL_INVALID_INDEX);
+    glUniformBlockBinding(shader.id(), index, Binding);
+    #else
+    static_cast<void>(shader);
+    #endif
+}
+
+FrameUniforms::FrameUniforms(): data{}, valid(false) {
+    static_assert(sizeof(Data) == 112, "improper size of frame uniform data");
+    CORRADE_INTERNAL_ASSERT(isSupported());
+    buffer.setData(Containers::ArrayView<const Data>{&data, 1}, BufferUsage::DynamicDraw);
+}
+
+void FrameUniforms::set(const Matrix4& projectionMatrix, const Vector3& lightPosition, const Color3& ambientColor, const Color3& specularColor) {
+    Data next{};
+    next.projectionMatrix = projectionMatrix;
+    next.lightPosition = lightPosition;
+    next.ambientColor = ambientColor;
+    next.specularColor = specularColor;
+
+    if(!valid || std::memcmp(&next, &data, sizeof(Data)) != 0) {
+        data = next;
+        buffer.setSubData(0, Containers::ArrayView<const Data>{&data, 1});
+        valid = true;
+    }
+
+    #ifndef MAGNUM_TARGET_GLES2
+    buffer.bind(Buffer::Target::Uniform, Binding);
+    #endif
+}
+
+}}
@@ -0,0 +1,14 @@
+/* Keep in sync with FrameUniforms::Data */
+#ifdef UNIFORM_BUFFERS
+layout(std140) uniform Frame {
+    highp mat4 projectionMatrix;
+    highp vec3 lightPosition;
+    lowp vec3 ambientColor;
+    lowp vec3 specularColor;
+};
+#else
+uniform highp mat4 projectionMatrix;
+uniform highp vec3 lightPosition;
+uniform lowp vec3 ambientColor;
+uniform lowp vec3 specularColor;
+#endif
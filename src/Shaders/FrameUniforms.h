@@ -0,0 +1,78 @@
+#ifndef PushTheBox_Shaders_FrameUniforms_h
+#define PushTheBox_Shaders_FrameUniforms_h
+
+/** @file
+ * @brief Class PushTheBox::Shaders::FrameUniforms
+ */
+
+#include <string>
+#include <Magnum/Buffer.h>
+#include <Magnum/Color.h>
+#include <Magnum/Math/Matrix4.h>
+
+#include "PushTheBox.h"
+
+namespace PushTheBox { namespace Shaders {
+
+/**
+@brief Per-frame uniform buffer
+
+Projection, light position and global colors shared by all scene shaders,
+uploaded once per frame into a uniform buffer bound to @ref Binding. The
+shaders declare them through `FrameUniforms.glsl`, which is a uniform block
+if @ref isSupported() and plain uniforms otherwise. In the latter case (ES2,
+WebGL 1) the values have to be set on each shader separately.
+*/
+class FrameUniforms {
+    public:
+        /** @brief Uniform buffer binding point */
+        enum: UnsignedInt { Binding = 0 };
+
+        /** @brief Whether uniform buffers are supported */
+        static bool isSupported();
+
+        /**
+         * @brief Shader source prefix
+         *
+         * Defines used by `FrameUniforms.glsl`, to be added before it.
+         */
+        static std::string shaderDefines();
+
+        /**
+         * @brief Set up shader
+         *
+         * Binds the uniform block of linked @p shader to @ref Binding, if
+         * uniform buffers are supported.
+         */
+        static void setupShader(AbstractShaderProgram& shader);
+
+        explicit FrameUniforms();
+
+        /**
+         * @brief Set the values and bind the buffer
+         *
+         * The buffer is updated only if the values changed since last
+         * call.
+         */
+        void set(const Matrix4& projectionMatrix, const Vector3& lightPosition, const Color3& ambientColor, const Color3& specularColor);
+
+    private:
+        /* std140 layout, vec3 is aligned to 16 bytes */
+        struct Data {
+            Matrix4 projectionMatrix;
+            Vector3 lightPosition;
+            Float padding0;
+            Color3 ambientColor;
+            Float padding1;
+            Color3 specularColor;
+            Float padding2;
+        };
+
+        Buffer buffer;
+        Data data;
+        bool valid;
+};
+
+}}
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef NEW_GLSL
+#define in varying
+#define fragmentColor gl_FragColor
+#define texture texture2D
+#endif
+
+#ifdef EXPLICIT_TEXTURE_LAYER
+layout(binding = 16) uniform sampler2D textureData;
+#else
+uniform sampler2D textureData;
+#endif
+
+in mediump vec2 textureCoords;
+
+#ifdef NEW_GLSL
+out mediump vec4 fragmentColor;
+#endif
+
+void main() {
+    fragmentColor = texture(textureData, textureCoords);
+}
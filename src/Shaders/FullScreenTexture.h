@@ -0,0 +1,33 @@
+#ifndef PushTheBox_Shaders_FullScreenTexture_h
+#define PushTheBox_Shaders_FullScreenTexture_h
+
+/** @file
+ * @brief Class PushTheBox::Shaders::FullScreenTexture
+ */
+
+#include <Magnum/AbstractShaderProgram.h>
+
+#include "PushTheBox.h"
+
+namespace PushTheBox { namespace Shaders {
+
+/**
+@brief Full screen texture shader
+
+Stretches a texture over the whole framebuffer. Meant to be used with the
+full screen triangle mesh, same as @ref Blur.
+*/
+class FullScreenTexture: public AbstractShaderProgram {
+    public:
+        /** @brief Vertex position, used only on GLSL without `gl_VertexID` */
+        typedef Attribute<0, Vector2> Position;
+
+        explicit FullScreenTexture();
+
+        /** @brief Set texture to display */
+        FullScreenTexture& setTexture(Texture2D& texture);
+};
+
+}}
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef NEW_GLSL
+#define out varying
+#endif
+
+out mediump vec2 textureCoords;
+
+void main() {
+    fullScreenTriangle();
+
+    textureCoords = gl_Position.xy*0.5 + vec2(0.5);
+}
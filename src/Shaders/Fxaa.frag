@@ -0,0 +1,63 @@
+#ifndef NEW_GLSL
+#define in varying
+#define fragmentColor gl_FragColor
+#define texture texture2D
+#endif
+
+#ifdef EXPLICIT_TEXTURE_LAYER
+layout(binding = 16) uniform sampler2D textureData;
+#else
+uniform sampler2D textureData;
+#endif
+
+/* Longest blur along the edge in pixels and how much noisy dark areas are
+   left alone */
+#define SPAN_MAX 8.0
+#define REDUCE_MUL (1.0/8.0)
+#define REDUCE_MIN (1.0/128.0)
+
+in mediump vec2 textureCoords;
+in mediump vec2 pixelSize;
+in mediump vec4 diagonalTextureCoords[2];
+
+#ifdef NEW_GLSL
+out mediump vec4 fragmentColor;
+#endif
+
+mediump float luma(mediump vec3 color) {
+    return dot(color, vec3(0.299, 0.587, 0.114));
+}
+
+void main() {
+    mediump vec3 center = texture(textureData, textureCoords).rgb;
+    mediump float lumaCenter = luma(center);
+    mediump float lumaNW = luma(texture(textureData, diagonalTextureCoords[0].xy).rgb);
+    mediump float lumaNE = luma(texture(textureData, diagonalTextureCoords[0].zw).rgb);
+    mediump float lumaSW = luma(texture(textureData, diagonalTextureCoords[1].xy).rgb);
+    mediump float lumaSE = luma(texture(textureData, diagonalTextureCoords[1].zw).rgb);
+
+    mediump float lumaMin = min(lumaCenter, min(min(lumaNW, lumaNE), min(lumaSW, lumaSE)));
+    mediump float lumaMax = max(lumaCenter, max(max(lumaNW, lumaNE), max(lumaSW, lumaSE)));
+
+    /* Edge direction is perpendicular to the luminance gradient. Texture
+       coordinates go up, so north is +y, unlike in the original FXAA. */
+    mediump vec2 direction = vec2(
+        (lumaNW + lumaNE) - (lumaSW + lumaSE),
+        (lumaNW + lumaSW) - (lumaNE + lumaSE));
+    mediump float reduce = max((lumaNW + lumaNE + lumaSW + lumaSE)*(0.25*REDUCE_MUL), REDUCE_MIN);
+    mediump float scale = 1.0/(min(abs(direction.x), abs(direction.y)) + reduce);
+    direction = clamp(direction*scale, vec2(-SPAN_MAX), vec2(SPAN_MAX))*pixelSize;
+
+    /* Two taps close to the center and two at the ends of the span */
+    mediump vec3 near = 0.5*(
+        texture(textureData, textureCoords + direction*(1.0/3.0 - 0.5)).rgb +
+        texture(textureData, textureCoords + direction*(2.0/3.0 - 0.5)).rgb);
+    mediump vec3 far = near*0.5 + 0.25*(
+        texture(textureData, textureCoords - direction*0.5).rgb +
+        texture(textureData, textureCoords + direction*0.5).rgb);
+
+    /* The wide blur crossed another edge, use the narrow one */
+    mediump float lumaFar = luma(far);
+    fragmentColor.rgb = lumaFar < lumaMin || lumaFar > lumaMax ? near : far;
+    fragmentColor.a = 1.0;
+}
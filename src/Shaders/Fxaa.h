@@ -0,0 +1,46 @@
+#ifndef PushTheBox_Shaders_Fxaa_h
+#define PushTheBox_Shaders_Fxaa_h
+
+/** @file
+ * @brief Class PushTheBox::Shaders::Fxaa
+ */
+
+#include <Magnum/AbstractShaderProgram.h>
+
+#include "PushTheBox.h"
+
+namespace PushTheBox { namespace Shaders {
+
+/**
+@brief Fast approximate antialiasing shader
+
+Single-pass post filter in the spirit of FXAA. Finds edges from luminance of
+the four diagonal neighbors and blurs along them with up to four bilinear
+fetches, pixels without an edge are passed through. Meant to be used with the
+full screen triangle mesh as a replacement for @ref FullScreenTexture. The
+source texture needs linear filtering.
+*/
+class Fxaa: public AbstractShaderProgram {
+    public:
+        /** @brief Vertex position, used only on GLSL without `gl_VertexID` */
+        typedef Attribute<0, Vector2> Position;
+
+        explicit Fxaa();
+
+        /**
+         * @brief Set inverted size of the source texture
+         *
+         * Needed only on GLSL without `textureSize()`.
+         */
+        Fxaa& setImageSizeInverted(const Vector2& size);
+
+        /** @brief Set source texture */
+        Fxaa& setTexture(Texture2D& texture);
+
+    private:
+        Int imageSizeInvertedUniform;
+};
+
+}}
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef NEW_GLSL
+#define out varying
+#endif
+
+#ifdef NEW_GLSL
+#ifdef EXPLICIT_TEXTURE_LAYER
+layout(binding = 16) uniform sampler2D textureData;
+#else
+uniform sampler2D textureData;
+#endif
+#else
+uniform vec2 imageSizeInverted;
+#endif
+
+out mediump vec2 textureCoords;
+out mediump vec2 pixelSize;
+out mediump vec4 diagonalTextureCoords[2];
+
+void main() {
+    fullScreenTriangle();
+
+    textureCoords = gl_Position.xy*0.5 + vec2(0.5);
+
+    #ifdef NEW_GLSL
+    pixelSize = 1.0/vec2(textureSize(textureData, 0));
+    #else
+    pixelSize = imageSizeInverted;
+    #endif
+
+    /* Northwest, northeast, southwest and southeast neighbors */
+    diagonalTextureCoords[0].xy = textureCoords + vec2(-pixelSize.x,  pixelSize.y);
+    diagonalTextureCoords[0].zw = textureCoords + vec2( pixelSize.x,  pixelSize.y);
+    diagonalTextureCoords[1].xy = textureCoords + vec2(-pixelSize.x, -pixelSize.y);
+    diagonalTextureCoords[1].zw = textureCoords + vec2( pixelSize.x, -pixelSize.y);
+}
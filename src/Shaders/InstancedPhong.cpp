@@ -0,0 +1,62 @@
+#include "InstancedPhong.h"
+
+#include <Corrade/Utility/Assert.h>
+#include <Corrade/Utility/Resource.h>
+#include <Magnum/Context.h>
+#include <Magnum/Shader.h>
+
+#include "Shaders/FrameUniforms.h"
+
+namespace PushTheBox { namespace Shaders {
+
+InstancedPhong::InstancedPhong(): projectionMatrixUniform(-1), lightPositionUniform(-1), ambientColorUniform(-1), specularColorUniform(-1) {
+    Utility::Resource mr("MagnumShaders");
+    Utility::Resource rs("PushTheBoxShaders");
+
+    #ifndef MAGNUM_TARGET_GLES
+    const Version v = Context::current().supportedVersion({Version::GL320, Version::GL210});
+    #else
+    const Version v = Context::current().supportedVersion({Version::GLES300, Version::GLES200});
+    #endif
+
+    Shader vert(v, Shader::Type::Vertex);
+    Shader frag(v, Shader::Type::Fragment);
+
+    vert.addSource("#define INSTANCED\n")
+        .addSource(FrameUniforms::shaderDefines())
+        .addSource(mr.get("compatibility.glsl"))
+        .addSource(rs.get("FrameUniforms.glsl"))
+        .addSource(rs.get("Phong.vert"));
+    frag.addSource("#define INSTANCED\n")
+        .addSource(FrameUniforms::shaderDefines())
+        .addSource(mr.get("compatibility.glsl"))
+        .addSource(rs.get("FrameUniforms.glsl"))
+        .addSource(rs.get("Phong.frag"));
+
+    CORRADE_INTERNAL_ASSERT_OUTPUT(Shader::compile({vert, frag}));
+
+    attachShaders({vert, frag});
+
+    bindAttributeLocation(Position::Location, "position");
+    bindAttributeLocation(Normal::Location, "normal");
+    bindAttributeLocation(TransformationMatrix::Location, "instancedTransformationMatrix");
+    bindAttributeLocation(Color::Location, "instancedColor");
+
+    CORRADE_INTERNAL_ASSERT_OUTPUT(link());
+
+    transformationMatrixUniform = uniformLocation("transformationMatrix");
+    normalMatrixUniform = uniformLocation("normalMatrix");
+    shininessUniform = uniformLocation("shininess");
+    if(FrameUniforms::isSupported()) FrameUniforms::setupShader(*this);
+    else {
+        projectionMatrixUniform = uniformLocation("projectionMatrix");
+        lightPositionUniform = uniformLocation("lightPosition");
+        ambientColorUniform = uniformLocation("ambientColor");
+        specularColorUniform = uniformLocation("specularColor");
+    }
+
+    /* Same default as Magnum's Phong */
+    setShininess(80.0f);
+}
+
+}}
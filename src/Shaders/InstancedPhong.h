@@ -0,0 +1,98 @@
+#ifndef PushTheBox_Shaders_InstancedPhong_h
+#define PushTheBox_Shaders_InstancedPhong_h
+
+/** @file
+ * @brief Class PushTheBox::Shaders::InstancedPhong
+ */
+
+#include <Magnum/AbstractShaderProgram.h>
+#include <Magnum/Color.h>
+#include <Magnum/Math/Matrix4.h>
+
+#include "PushTheBox.h"
+
+namespace PushTheBox { namespace Shaders {
+
+/**
+@brief Instanced Phong shader
+
+Same lighting as @magnumref{Shaders::Phong}, but the transformation and
+diffuse color are per-instance attributes. Vertex attribute locations are
+compatible with @magnumref{Shaders::Phong}, so the same vertex buffers can be
+used with both.
+
+If @ref FrameUniforms are supported, projection, light position, ambient
+and specular color are taken from there and the corresponding setters have
+no effect.
+*/
+class InstancedPhong: public AbstractShaderProgram {
+    public:
+        /** @brief Vertex position */
+        typedef Attribute<0, Vector3> Position;
+
+        /** @brief Normal direction */
+        typedef Attribute<2, Vector3> Normal;
+
+        /** @brief Per-instance transformation, occupies four locations */
+        typedef Attribute<3, Matrix4> TransformationMatrix;
+
+        /** @brief Per-instance diffuse color */
+        typedef Attribute<7, Color3> Color;
+
+        explicit InstancedPhong();
+
+        /** @brief Set transformation applied to all instances */
+        InstancedPhong& setTransformationMatrix(const Matrix4& matrix) {
+            setUniform(transformationMatrixUniform, matrix);
+            return *this;
+        }
+
+        /** @brief Set normal matrix */
+        InstancedPhong& setNormalMatrix(const Matrix3x3& matrix) {
+            setUniform(normalMatrixUniform, matrix);
+            return *this;
+        }
+
+        /** @brief Set projection matrix */
+        InstancedPhong& setProjectionMatrix(const Matrix4& matrix) {
+            setUniform(projectionMatrixUniform, matrix);
+            return *this;
+        }
+
+        /** @brief Set light position in camera space */
+        InstancedPhong& setLightPosition(const Vector3& light) {
+            setUniform(lightPositionUniform, light);
+            return *this;
+        }
+
+        /** @brief Set ambient color */
+        InstancedPhong& setAmbientColor(const Color3& color) {
+            setUniform(ambientColorUniform, color);
+            return *this;
+        }
+
+        /** @brief Set specular color */
+        InstancedPhong& setSpecularColor(const Color3& color) {
+            setUniform(specularColorUniform, color);
+            return *this;
+        }
+
+        /** @brief Set shininess */
+        InstancedPhong& setShininess(Float shininess) {
+            setUniform(shininessUniform, shininess);
+            return *this;
+        }
+
+    private:
+        Int transformationMatrixUniform,
+            projectionMatrixUniform,
+            normalMatrixUniform,
+            lightPositionUniform,
+            ambientColorUniform,
+            specularColorUniform,
+            shininessUniform;
+};
+
+}}
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef NEW_GLSL
+#define in varying
+#define fragmentColor gl_FragColor
+#endif
+
+uniform mediump float shininess;
+
+in mediump vec3 transformedNormal;
+in highp vec3 lightDirection;
+in highp vec3 cameraDirection;
+#ifdef INSTANCED
+in lowp vec3 diffuseColor;
+#else
+uniform lowp vec3 diffuseColor;
+#endif
+
+#ifdef NEW_GLSL
+out lowp vec4 fragmentColor;
+#endif
+
+void main() {
+    /* Ambient color */
+    fragmentColor.rgb = ambientColor;
+
+    mediump vec3 normalizedTransformedNormal = normalize(transformedNormal);
+    highp vec3 normalizedLightDirection = normalize(lightDirection);
+
+    /* Add diffuse color */
+    lowp float intensity = max(0.0, dot(normalizedTransformedNormal, normalizedLightDirection));
+    fragmentColor.rgb += diffuseColor*intensity;
+
+    /* Add specular color, if needed */
+    if(intensity > 0.001) {
+        highp vec3 reflection = reflect(-normalizedLightDirection, normalizedTransformedNormal);
+        mediump float specularity = pow(max(0.0, dot(normalize(cameraDirection), reflection)), shininess);
+        fragmentColor.rgb += specularColor*specularity;
+    }
+
+    fragmentColor.a = 1.0;
+}
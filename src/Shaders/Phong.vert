@@ -0,0 +1,58 @@
+#ifndef NEW_GLSL
+#define in attribute
+#define out varying
+#endif
+
+uniform highp mat4 transformationMatrix;
+uniform mediump mat3 normalMatrix;
+
+in highp vec4 position;
+in mediump vec3 normal;
+
+#ifdef INSTANCED
+in highp mat4 instancedTransformationMatrix;
+in lowp vec3 instancedColor;
+#endif
+
+out mediump vec3 transformedNormal;
+out highp vec3 lightDirection;
+out highp vec3 cameraDirection;
+#ifdef INSTANCED
+out lowp vec3 diffuseColor;
+#endif
+
+/* Depth has to match the depth pre-pass done with Unshaded.vert */
+invariant gl_Position;
+
+void main() {
+    /* Transformed vertex position */
+    #ifdef INSTANCED
+    highp vec4 transformedPosition4 = transformationMatrix*instancedTransformationMatrix*position;
+    #else
+    highp vec4 transformedPosition4 = transformationMatrix*position;
+    #endif
+    highp vec3 transformedPosition = transformedPosition4.xyz/transformedPosition4.w;
+
+    /* Transformed normal vector, matrix-from-matrix constructor is not
+       available in GLSL ES 1.00 */
+    #ifdef INSTANCED
+    transformedNormal = normalMatrix*mat3(instancedTransformationMatrix[0].xyz,
+                                          instancedTransformationMatrix[1].xyz,
+                                          instancedTransformationMatrix[2].xyz)*normal;
+    #else
+    transformedNormal = normalMatrix*normal;
+    #endif
+
+    /* Direction to the light */
+    lightDirection = normalize(lightPosition - transformedPosition);
+
+    /* Direction to the camera */
+    cameraDirection = -transformedPosition;
+
+    #ifdef INSTANCED
+    diffuseColor = instancedColor;
+    #endif
+
+    /* Transform the position */
+    gl_Position = projectionMatrix*transformedPosition4;
+}
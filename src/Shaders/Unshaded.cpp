@@ -0,0 +1,46 @@
+#include "Unshaded.h"
+
+#include <Corrade/Utility/Assert.h>
+#include <Corrade/Utility/Resource.h>
+#include <Magnum/Context.h>
+#include <Magnum/Shader.h>
+
+#include "Shaders/FrameUniforms.h"
+
+namespace PushTheBox { namespace Shaders {
+
+Unshaded::Unshaded(): projectionMatrixUniform(-1) {
+    Utility::Resource mr("MagnumShaders");
+    Utility::Resource rs("PushTheBoxShaders");
+
+    #ifndef MAGNUM_TARGET_GLES
+    const Version v = Context::current().supportedVersion({Version::GL320, Version::GL210});
+    #else
+    const Version v = Context::current().supportedVersion({Version::GLES300, Version::GLES200});
+    #endif
+
+    Shader vert(v, Shader::Type::Vertex);
+    Shader frag(v, Shader::Type::Fragment);
+
+    vert.addSource(FrameUniforms::shaderDefines())
+        .addSource(mr.get("compatibility.glsl"))
+        .addSource(rs.get("FrameUniforms.glsl"))
+        .addSource(rs.get("Unshaded.vert"));
+    frag.addSource(mr.get("compatibility.glsl"))
+        .addSource(rs.get("Unshaded.frag"));
+
+    CORRADE_INTERNAL_ASSERT_OUTPUT(Shader::compile({vert, frag}));
+
+    attachShaders({vert, frag});
+
+    bindAttributeLocation(Position::Location, "position");
+
+    CORRADE_INTERNAL_ASSERT_OUTPUT(link());
+
+    transformationMatrixUniform = uniformLocation("transformationMatrix");
+    colorUniform = uniformLocation("color");
+    if(FrameUniforms::isSupported()) FrameUniforms::setupShader(*this);
+    else projectionMatrixUniform = uniformLocation("projectionMatrix");
+}
+
+}}
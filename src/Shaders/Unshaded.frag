@@ -0,0 +1,13 @@
+#ifndef NEW_GLSL
+#define fragmentColor gl_FragColor
+#endif
+
+uniform lowp vec4 color;
+
+#ifdef NEW_GLSL
+out lowp vec4 fragmentColor;
+#endif
+
+void main() {
+    fragmentColor = color;
+}
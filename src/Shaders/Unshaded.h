@@ -0,0 +1,62 @@
+#ifndef PushTheBox_Shaders_Unshaded_h
+#define PushTheBox_Shaders_Unshaded_h
+
+/** @file
+ * @brief Class PushTheBox::Shaders::Unshaded
+ */
+
+#include <Magnum/AbstractShaderProgram.h>
+#include <Magnum/Color.h>
+#include <Magnum/Math/Matrix4.h>
+
+#include "PushTheBox.h"
+
+namespace PushTheBox { namespace Shaders {
+
+/**
+@brief Unshaded shader
+
+Outputs a single color without any lighting, for depth-only passes and
+debug visualizations. The vertex position is transformed exactly the same
+way as in @ref CachedPhong, so the depth values match and a Phong pass with
+@ref Renderer::DepthFunction::LessOrEqual passes only the fragments written
+here. Vertex attribute location is compatible with
+@magnumref{Shaders::Phong}.
+
+If @ref FrameUniforms are supported, projection is taken from there and
+@ref setProjectionMatrix() has no effect.
+*/
+class Unshaded: public AbstractShaderProgram {
+    public:
+        /** @brief Vertex position */
+        typedef Attribute<0, Vector3> Position;
+
+        explicit Unshaded();
+
+        /** @brief Set transformation matrix */
+        Unshaded& setTransformationMatrix(const Matrix4& matrix) {
+            setUniform(transformationMatrixUniform, matrix);
+            return *this;
+        }
+
+        /** @brief Set projection matrix */
+        Unshaded& setProjectionMatrix(const Matrix4& matrix) {
+            setUniform(projectionMatrixUniform, matrix);
+            return *this;
+        }
+
+        /** @brief Set output color */
+        Unshaded& setColor(const Color4& color) {
+            setUniform(colorUniform, color);
+            return *this;
+        }
+
+    private:
+        Int transformationMatrixUniform,
+            projectionMatrixUniform,
+            colorUniform;
+};
+
+}}
+
+#endif
@@ -0,0 +1,16 @@
+#ifndef NEW_GLSL
+#define in attribute
+#endif
+
+uniform highp mat4 transformationMatrix;
+
+in highp vec4 position;
+
+/* Same operations as in Phong.vert, but only invariance guarantees the same
+   depth in different programs */
+invariant gl_Position;
+
+void main() {
+    highp vec4 transformedPosition4 = transformationMatrix*position;
+    gl_Position = projectionMatrix*transformedPosition4;
+}
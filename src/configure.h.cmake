@@ -1,2 +1,8 @@
 #define MAGNUM_PLUGINS_FONT_DIR "${MAGNUM_PLUGINS_FONT_DIR}"
 #define MAGNUM_PLUGINS_IMPORTER_DIR "${MAGNUM_PLUGINS_IMPORTER_DIR}"
+#define MAGNUM_PLUGINS_IMAGECONVERTER_DIR "${MAGNUM_PLUGINS_IMAGECONVERTER_DIR}"
+#cmakedefine PUSHTHEBOX_WITH_EDITOR
+#cmakedefine PUSHTHEBOX_WITH_PROFILING
+#cmakedefine PUSHTHEBOX_WITH_BENCHMARK
+#cmakedefine PUSHTHEBOX_WITH_HEADLESS
+#cmakedefine PUSHTHEBOX_WITH_SIMULATION_THREAD